@@ -1,17 +1,22 @@
-// actor_test.cpp : ̨Ӧóڵ㡣
+// actor_test.cpp : 定义控制台应用程序的入口点。
 //
 
 #include "ios_proxy.h"
 #include "actor_framework.h"
 #include "async_buffer.h"
 #include "scattered.h"
+#include "actor_bench.h"
+#include "net_bench.h"
+#include "alloc_test.h"
+#include "self_check.h"
+#include "remote_actor.h"
 #include <list>
 #include <Windows.h>
 
 using namespace std;
 
 void check_key_down(my_actor* self, int id)
-{//ⰴ
+{//检测按键按下
 	while (GetAsyncKeyState(id) >= 0)
 	{
 		self->sleep(1);
@@ -19,7 +24,7 @@ void check_key_down(my_actor* self, int id)
 }
 
 void check_key_up(my_actor* self, int id)
-{//ⰴ
+{//检测按键弹起
 	while (GetAsyncKeyState(id) < 0)
 	{
 		self->sleep(1);
@@ -29,26 +34,26 @@ void check_key_up(my_actor* self, int id)
 void check_key_test(my_actor* self, int id)
 {
 	while (true)
-	{//º󣬼ⵯ1000msûеǳʱ
-		check_key_down(self, id);//ⰴ
-		child_actor_handle checkUp = self->create_child_actor(boost::bind(&check_key_up, _1, id), 24 kB);//һⵯActor
-		self->child_actor_run(checkUp);//ʼActor
-		self->delay_trig(1000, boost::bind(&my_actor::notify_quit, checkUp.get_actor()));//õʱʱǿƹرcheckUp
-		if (self->child_actor_wait_quit(checkUp))//˳ķtrueǿƹرյķfalse
+	{//按键按下后，检测弹起，1000ms内没有弹起就是超时错误
+		check_key_down(self, id);//检测按下
+		child_actor_handle checkUp = self->create_child_actor(boost::bind(&check_key_up, _1, id), 24 kB);//创建一个检测弹起的子Actor
+		self->child_actor_run(checkUp);//开始运行子Actor
+		self->delay_trig(1000, boost::bind(&my_actor::notify_quit, checkUp.get_actor()));//启用弹起超时处理，超时后强制关闭checkUp
+		if (self->child_actor_wait_quit(checkUp))//正常退出的返回true，被强制关闭的返回false
 		{
 			self->cancel_delay_trig();
 			printf("ok %d\n", id);
 		} 
 		else
-		{//ʱ
+		{//弹起超时
 			printf("timeout %d\n", id);
-			check_key_up(self, id);//ⵯ
+			check_key_up(self, id);//检测弹起
 		}
 	}
 }
 
 void actor_print(my_actor* self, int id)
-{//ºȴӡһַ500msÿ50msӡһ
+{//按下后先打印一个字符，500ms后每隔50ms打印一次
 	printf("_");
 	self->sleep(500);
 	while (true)
@@ -62,10 +67,10 @@ void actor_test_print(my_actor* self, int id)
 {
 	while (true)
 	{
-		check_key_down(self, id);//ⰴ
+		check_key_down(self, id);//检测按下
 		child_actor_handle ch = self->create_child_actor(boost::bind(&actor_print, _1, id));
 		self->child_actor_run(ch);
-		check_key_up(self, id);//ⵯ
+		check_key_up(self, id);//检测弹起
 		self->child_actor_force_quit(ch);
 	}
 }
@@ -107,7 +112,7 @@ void check_two_down(my_actor* self, int dt, int id1, int id2)
 {
 	while (true)
 	{
-		{//Ƿ񶼴ڵ״̬
+		{//检测两个按键是否都处于弹起状态
 			bool st1 = false;
 			bool st2 = false;
 			child_actor_handle up1 = self->create_child_actor(boost::bind(&check_both_up, _1, id1, boost::ref(st1), boost::ref(st2)));
@@ -125,7 +130,7 @@ void check_two_down(my_actor* self, int dt, int id1, int id2)
 			}
 			else
 			{
-				printf("˳ check_two_down\n");
+				printf("退出 check_two_down\n");
 				self->child_actor_force_quit(up1);
 				self->child_actor_force_quit(up2);
 				self->close_trig_notifer(ath);
@@ -189,7 +194,7 @@ void shift_key(my_actor* self, actor_handle pauseactor)
 		if ('P' == id)
 		{
 			bool isPause = self->actor_switch(pauseactor);
-			printf("%sܲ\n", isPause? "ͣ": "ָ");
+			printf("%s性能测试\n", isPause? "暂停": "恢复");
 		}
 		else
 		{
@@ -258,9 +263,9 @@ void perfor_test(my_actor* self, ios_proxy& ios)
 			ct += count[i];
 		}
 		double f = (double)ct * 1000000 / (get_tick_us()-tk);
-		printf("Actor=%d, лƵ=%d\n", num, (int)f);
+		printf("Actor数=%d, 切换频率=%d\n", num, (int)f);
 	}
-	printf("ܲԽ\n");
+	printf("性能测试结束\n");
 }
 
 void create_null_actor(my_actor* self, int* count)
@@ -293,34 +298,34 @@ void create_actor_test(my_actor* self)
 		self->child_actor_run(createactor);
 		self->sleep(1000);
 		self->child_actor_force_quit(createactor);
-		printf("1봴Actor=%d\n", count);
+		printf("1秒创建Actor数=%d\n", count);
 	}
 }
 
 void actor_test(my_actor* self)
 {
-	ios_proxy perforIos;//ڲԶ߳µActorл
-	perforIos.run(ios_proxy::hardwareConcurrency());//߳ΪCPU߳
-	perforIos.runPriority(ios_proxy::idle);//ȼΪ
+	ios_proxy perforIos(ios_proxy::hardwareConcurrency());//用于测试多线程下的Actor切换性能
+	perforIos.run(ios_proxy::hardwareConcurrency());//调度器线程设置为CPU线程数
+	perforIos.runPriority(ios_proxy::idle);//调度器优先级设置为最低
 	child_actor_handle actorLeft = self->create_child_actor(boost::bind(&check_key_test, _1, VK_LEFT));
 	child_actor_handle actorRight = self->create_child_actor(boost::bind(&check_key_test, _1, VK_RIGHT));
 	child_actor_handle actorUp = self->create_child_actor(boost::bind(&check_key_test, _1, VK_UP));
 	child_actor_handle actorDown = self->create_child_actor(boost::bind(&check_key_test, _1, VK_DOWN));
-	child_actor_handle actorPrint = self->create_child_actor(boost::bind(&actor_test_print, _1, VK_SPACE));//ո
-	child_actor_handle actorTwo = self->create_child_actor(boost::bind(&check_two_down, _1, 10, 'D', 'F'));//D,FǷͬʱ(ü10ms)
-	child_actor_handle actorPerfor = self->create_child_actor(boost::bind(&perfor_test, _1, boost::ref(perforIos)));//Actorлܲ
-	child_actor_handle actorCreate = self->create_child_actor(boost::bind(&create_actor_test, _1));//Actorܲ
-	child_actor_handle actorShift = self->create_child_actor(boost::bind(&test_shift, _1, actorPerfor.get_actor()));//shift+ĸ
+	child_actor_handle actorPrint = self->create_child_actor(boost::bind(&actor_test_print, _1, VK_SPACE));//检测空格键
+	child_actor_handle actorTwo = self->create_child_actor(boost::bind(&check_two_down, _1, 10, 'D', 'F'));//检测D,F键是否同时按下(设置间隔误差10ms)
+	child_actor_handle actorPerfor = self->create_child_actor(boost::bind(&perfor_test, _1, boost::ref(perforIos)));//Actor切换性能测试
+	child_actor_handle actorCreate = self->create_child_actor(boost::bind(&create_actor_test, _1));//Actor创建性能测试
+	child_actor_handle actorShift = self->create_child_actor(boost::bind(&test_shift, _1, actorPerfor.get_actor()));//shift+字母检测
 	child_actor_handle actorProducer1;
 	child_actor_handle actorProducer2;
 	child_actor_handle actorConsumer;
 	child_actor_handle actorMutex1;
 	child_actor_handle actorMutex2;
 	child_actor_handle actorMutex3;
-	///ģͲ
-	{//ģϢתתл
+	//创建生产者/消费者模型测试
+	{//模拟消息转发，转发切换
 		actorConsumer = self->create_child_actor(self->self_strand()->clone(), [](my_actor* self)
-		{//
+		{//消费者
 			auto agentRun = [](my_actor* self)
 			{
 				auto conCmh = self->connect_msg_pump<int, int>();
@@ -332,13 +337,13 @@ void actor_test(my_actor* self)
 					try
 					{
 						self->pump_msg(conCmh, p0, id, true);
-						printf(":%d :%d :%d\n", p0, id, (int)self->self_id());
+						printf("数据:%d 发送者:%d 接收者:%d\n", p0, id, (int)self->self_id());
 						continue;
 					} catch (my_actor::pump_disconnected_exception) {}
-					printf(":%d Ͽ\n", (int)self->self_id());//Ϣñرգ׳쳣
+					printf("接收者:%d 被断开\n", (int)self->self_id());//消息泵被父关闭，抛出异常
 				__start:;
 					self->pump_msg(conCmh, p0, id);
-					printf(":%d :%d :%d\n", p0, id, (int)self->self_id());
+					printf("数据:%d 发送者:%d 接收者:%d\n", p0, id, (int)self->self_id());
 				}
 			};
 			auto st = self->self_strand()->clone();
@@ -348,26 +353,26 @@ void actor_test(my_actor* self)
 			self->child_actor_run(agent2);
 			while (true)
 			{
-				self->msg_agent_to<int, int>(agent1);//Ϣagent1
+				self->msg_agent_to<int, int>(agent1);//消息由agent1代理
 				self->sleep(5000);
-				self->msg_agent_to<int, int>(agent2);//Ͽagent1лagent2
+				self->msg_agent_to<int, int>(agent2);//断开agent1代理，切换到agent2代理
 				self->sleep(2000);
-				//self->msg_agent_off<int, int>();//Ͽagent2
+				//self->msg_agent_off<int, int>();//断开agent2代理
 				//self->sleep(200);
-				auto conCmh = self->connect_msg_pump<int, int>();//ֹͣϢԼ
+				auto conCmh = self->connect_msg_pump<int, int>();//停止消息代理，由自己处理
 				for (int i = 0; i < 3; i++)
 				{
 					int p0;
 					int id;
 					self->pump_msg(conCmh, p0, id);
-					printf(":%d :%d :%d\n", p0, id, (int)self->self_id());
+					printf("数据:%d 发送者:%d 接收者:%d\n", p0, id, (int)self->self_id());
 				}
 			}
 		});
 		self->child_actor_run(actorConsumer);
-		auto writer = self->connect_msg_notifer_to<int, int>(actorConsumer);//ϢactorConsumer
+		auto writer = self->connect_msg_notifer_to<int, int>(actorConsumer);//连接消息到actorConsumer
 		auto test_producer = [writer](my_actor* self)
-		{//
+		{//生产者
 			for (int i = 0; true; i++)
 			{
 				writer(i, (int)self->self_id());
@@ -382,10 +387,10 @@ void actor_test(my_actor* self)
 	{
 		actor_mutex amutex(self->self_strand());
 		auto actorMutexH = [amutex](my_actor* self)
-		{//ģactor_mutex
+		{//模拟actor_mutex互斥特性
 			while (true)
 			{
-				my_actor::quit_guard qg(self);//ڼ䲻Actorǿ˳
+				my_actor::quit_guard qg(self);//保护上锁期间不让Actor强制退出
 				actor_lock_guard lg(amutex, self);
 				for (int i = 0; i < 10; i++)
 				{
@@ -397,11 +402,11 @@ void actor_test(my_actor* self)
 		actorMutex1 = self->create_child_actor(actorMutexH);
 		actorMutex2 = self->create_child_actor(actorMutexH);
 		actorMutex3 = self->create_child_actor(actorMutexH);
-		self->child_actor_run(actorMutex1);//ģactor_mutex
+		self->child_actor_run(actorMutex1);//模拟actor_mutex互斥特性
 		self->child_actor_run(actorMutex2);
 		self->child_actor_run(actorMutex3);
 	}
-	list<actor_handle> chs;//ҪActor󣬿Դ·עͼ
+	list<actor_handle> chs;//需要被挂起的Actor对象，可以从下方注释几个测试
 	chs.push_back(actorLeft.get_actor());
 	chs.push_back(actorRight.get_actor());
 	chs.push_back(actorUp.get_actor());
@@ -414,8 +419,8 @@ void actor_test(my_actor* self)
 	chs.push_back(actorProducer1.get_actor());
 	chs.push_back(actorProducer2.get_actor());
 	chs.push_back(actorCreate.get_actor());
-	child_actor_handle actorSuspend = self->create_child_actor(boost::bind(&actor_suspend, _1, boost::ref(chs)), 32 kB);//Ҽͣ
-	child_actor_handle actorResume = self->create_child_actor(boost::bind(&actor_resume, _1, boost::ref(chs)), 32 kB);//ָ
+	child_actor_handle actorSuspend = self->create_child_actor(boost::bind(&actor_suspend, _1, boost::ref(chs)), 32 kB);//点击鼠标右键暂停按键检测
+	child_actor_handle actorResume = self->create_child_actor(boost::bind(&actor_resume, _1, boost::ref(chs)), 32 kB);//点击鼠标左键恢复按键检测
 	self->child_actor_run(actorLeft);
 	self->child_actor_run(actorRight);
 	self->child_actor_run(actorUp);
@@ -428,7 +433,7 @@ void actor_test(my_actor* self)
 	self->child_actor_run(actorSuspend);
 	self->child_actor_run(actorResume);
 	self->child_actor_suspend(actorPerfor);
-	check_key_down(self, VK_ESCAPE);//ESC˳
+	check_key_down(self, VK_ESCAPE);//ESC键退出
 	self->child_actor_force_quit(actorLeft);
 	self->child_actor_force_quit(actorRight);
 	self->child_actor_force_quit(actorUp);
@@ -452,16 +457,150 @@ void actor_test(my_actor* self)
 	perforIos.stop();
 }
 
+void bench_test(my_actor* self, const char* filter, int rounds, int batch)
+{
+	ios_proxy benchIos(ios_proxy::hardwareConcurrency());
+	benchIos.run(ios_proxy::hardwareConcurrency());
+	actor_bench bench(benchIos, rounds, batch);
+	bench.run(self, filter);
+	printf("%s", bench.json().c_str());
+	benchIos.stop();
+}
+
+void alloc_check(my_actor* self, int ops, bool* ok)
+{
+	alloc_test test(ops);
+	*ok = test.run(self);
+	printf("%s", test.report().c_str());
+}
+
+void self_check_run(my_actor* self, bool* ok)
+{
+	self_check check;
+	*ok = check.run(self);
+	printf("%s", check.report().c_str());
+}
+
+void net_bench_test(my_actor* self, const net_bench_options& opt, bool loopback)
+{
+	ios_proxy netIos(ios_proxy::hardwareConcurrency());
+	netIos.run(ios_proxy::hardwareConcurrency());
+	{
+		net_bench bench(netIos);
+		if (!loopback || bench.start_echo(opt._port))
+		{
+			printf("%s", bench.run_load(self, opt).c_str());
+		}
+		else
+		{
+			printf("监听端口%d失败\n", (int)opt._port);
+		}
+	}
+	netIos.stop();
+}
+
+void net_server_test(my_actor* self, size_t port, const char* upstreamIp, size_t upstreamPort)
+{
+	ios_proxy netIos(ios_proxy::hardwareConcurrency());
+	netIos.run(ios_proxy::hardwareConcurrency());
+	{
+		net_bench bench(netIos);
+		if (upstreamIp ? bench.start_relay(port, upstreamIp, upstreamPort) : bench.start_echo(port))
+		{
+			printf("%s服务已启动，端口%d，ESC键退出\n", upstreamIp ? "转发" : "回显", (int)port);
+			check_key_down(self, VK_ESCAPE);
+		}
+		else
+		{
+			printf("监听端口%d失败\n", (int)port);
+		}
+	}
+	netIos.stop();
+}
+
+
+void remote_test(my_actor* self, size_t port, int count, bool* ok)
+{//两个remote_node各用一个调度器，经127.0.0.1互连，客户端发ping，服务端原样回pong
+	*ok = false;
+	ios_proxy serverIos(1);
+	ios_proxy clientIos(1);
+	serverIos.run(1);
+	clientIos.run(1);
+	{
+		std::shared_ptr<remote_node> server = remote_node::create(boost_strand::create(serverIos));
+		std::shared_ptr<remote_node> client = remote_node::create(boost_strand::create(clientIos));
+		actor_msg_handle<size_t, bool> peerAmh;
+		actor_msg_handle<size_t> connAmh;
+		actor_msg_handle<int> pongAmh;
+		server->peer_notify(self->make_msg_notifer(peerAmh));
+		client->regist<pod_codec, int>("pong", self->make_msg_notifer(pongAmh));
+		size_t serverPeer = 0, clientPeer = 0;
+		bool connected = false;
+		if (!server->listen(port))
+		{
+			printf("监听端口%d失败\n", (int)port);
+		}
+		else
+		{
+			client->connect("127.0.0.1", port, self->make_msg_notifer(connAmh));
+			if (self->timed_wait_msg(3000, connAmh, clientPeer) && clientPeer &&
+				self->timed_wait_msg(3000, peerAmh, serverPeer, connected) && connected)
+			{
+				server->regist<pod_codec, int>("ping", server->make_poster<pod_codec, int>(serverPeer, "pong"));
+				auto ping = client->make_poster<pod_codec, int>(clientPeer, "ping");
+				long long maxUs = 0;
+				long long begin = get_tick_us();
+				int i = 0;
+				for (; i < count; i++)
+				{
+					long long tk = get_tick_us();
+					ping(i);
+					int pong = -1;
+					if (!self->timed_wait_msg(1000, pongAmh, pong) || pong != i)
+					{
+						break;
+					}
+					tk = get_tick_us() - tk;
+					maxUs = tk > maxUs ? tk : maxUs;
+				}
+				long long totalUs = get_tick_us() - begin;
+				*ok = i == count;
+				printf("{\"remote\": {\"ok\": %s, \"round_trips\": %d, \"avg_rtt_us\": %.1f, \"max_rtt_us\": %lld}}\n",
+					*ok ? "true" : "false", i, i ? (double)totalUs / i : 0.0, maxUs);
+			}
+			else
+			{
+				printf("连接127.0.0.1:%d失败\n", (int)port);
+			}
+		}
+		server->unregist("ping");
+		client->unregist("pong");
+		client->close();
+		server->close();
+		self->close_msg_notifer(peerAmh);
+		self->close_msg_notifer(connAmh);
+		self->close_msg_notifer(pongAmh);
+	}
+	clientIos.stop();
+	serverIos.stop();
+}
+
 
 	/*
-	߼ƲԳ
-	ҷ⣬º1000msڵӡokӡtimeout;
-	ո⣬ºӡ _ 500msûеÿ50msӡ - ;
-	D,F⣬10ms"ͬʱ"("ͬʱ"һǰһ)ӡsuccessӡfailure;
-	갴⣬Ҽ¹»ָ;
-	/ģͲ;
-	ESC˳;
-	ע⣺ĳЩ֧̿ܲ2ϰͬʱ
+	逻辑控制测试程序
+	上下左右方向键检测，按下后1000ms内弹起打印ok，否则打印timeout;
+	空格键检测，按下后打印 _ ，500ms内没有弹起，每隔50ms打印 - ;
+	D,F键检测，10ms内两个键"同时"按下(必须"同时"，而不是一前一后)打印success，否则打印failure;
+	鼠标按键检测，右键按下挂起动作，左键按下恢复动作;
+	生产者/消费者模型测试;
+	ESC键退出;
+	命令行参数 --bench [用例名过滤] [轮数] [每轮次数] 运行基准测试，结果以JSON输出到标准输出;
+	命令行参数 --alloc [每用例次数] 检查消息/定时器/socket读等热点路径的内存分配次数，有不符的返回1;
+	命令行参数 --selfcheck 启用运行时间统计等诊断功能并检查其输出，有不符的返回1;
+	命令行参数 --netbench [连接数] [消息长度] [每连接每秒消息数] [时长ms] [窗口] 在本进程回显服务上做回环TCP压测;
+	命令行参数 --echo 端口 / --relay 端口 上游ip 上游端口 启动回显/转发服务，--load ip 端口 [连接数] ... 对其压测，结果以JSON输出;
+	命令行参数 --remote [端口] [次数] 两个remote_node经127.0.0.1互连做ping/pong往返，结果以JSON输出，失败返回1;
+	注意：某些键盘可能不支持2个以上按键同时操作
 	*/
 int main(int argc, char* argv[])
 {
@@ -469,6 +608,88 @@ int main(int argc, char* argv[])
 	my_actor::enable_stack_pool();
 	ios_proxy ios;
 	ios.run();
+	if (argc > 1 && 0 == strcmp(argv[1], "--bench"))
+	{
+		const char* filter = argc > 2 ? argv[2] : NULL;
+		int rounds = argc > 3 ? atoi(argv[3]) : 100;
+		int batch = argc > 4 ? atoi(argv[4]) : 1000;
+		actor_handle actorBench = my_actor::create(boost_strand::create(ios), boost::bind(&bench_test, _1, filter, rounds > 0 ? rounds : 100, batch > 0 ? batch : 1000));
+		actorBench->notify_run();
+		actorBench->outside_wait_quit();
+		ios.stop();
+		return 0;
+	}
+	if (argc > 1 && 0 == strcmp(argv[1], "--alloc"))
+	{
+		int ops = argc > 2 ? atoi(argv[2]) : 1000;
+		bool ok = false;
+		actor_handle actorAlloc = my_actor::create(boost_strand::create(ios), boost::bind(&alloc_check, _1, ops > 0 ? ops : 1000, &ok));
+		actorAlloc->notify_run();
+		actorAlloc->outside_wait_quit();
+		ios.stop();
+		return ok ? 0 : 1;
+	}
+	if (argc > 1 && 0 == strcmp(argv[1], "--selfcheck"))
+	{
+		self_check::enable();
+		bool ok = false;
+		actor_handle actorCheck = my_actor::create(boost_strand::create(ios), boost::bind(&self_check_run, _1, &ok));
+		actorCheck->notify_run();
+		actorCheck->outside_wait_quit();
+		ios.stop();
+		return ok ? 0 : 1;
+	}
+	if (argc > 1 && (0 == strcmp(argv[1], "--netbench") || 0 == strcmp(argv[1], "--load")))
+	{
+		bool loopback = 0 == strcmp(argv[1], "--netbench");
+		int i = 2;
+		net_bench_options opt;
+		if (!loopback)
+		{
+			opt._ip = argc > i ? argv[i] : "127.0.0.1";
+			i++;
+			opt._port = argc > i ? atoi(argv[i]) : opt._port;
+			i++;
+		}
+		opt._connections = argc > i ? atoi(argv[i]) : opt._connections;
+		opt._msgSize = argc > i + 1 ? atoi(argv[i + 1]) : opt._msgSize;
+		opt._rate = argc > i + 2 ? atoi(argv[i + 2]) : opt._rate;
+		opt._durationMs = argc > i + 3 ? atoi(argv[i + 3]) : opt._durationMs;
+		opt._window = argc > i + 4 ? atoi(argv[i + 4]) : opt._window;
+		if (opt._connections <= 0 || opt._msgSize < 16 || opt._msgSize >= 64 kB || opt._rate < 0 || opt._durationMs <= 0 || opt._window <= 0)
+		{
+			printf("参数错误\n");
+			ios.stop();
+			return 1;
+		}
+		actor_handle actorNet = my_actor::create(boost_strand::create(ios), boost::bind(&net_bench_test, _1, boost::cref(opt), loopback));
+		actorNet->notify_run();
+		actorNet->outside_wait_quit();
+		ios.stop();
+		return 0;
+	}
+	if (argc > 2 && (0 == strcmp(argv[1], "--echo") || 0 == strcmp(argv[1], "--relay")))
+	{
+		bool relay = 0 == strcmp(argv[1], "--relay");
+		const char* upstreamIp = relay ? (argc > 3 ? argv[3] : "127.0.0.1") : NULL;
+		size_t upstreamPort = relay && argc > 4 ? atoi(argv[4]) : 9000;
+		actor_handle actorNet = my_actor::create(boost_strand::create(ios), boost::bind(&net_server_test, _1, (size_t)atoi(argv[2]), upstreamIp, upstreamPort));
+		actorNet->notify_run();
+		actorNet->outside_wait_quit();
+		ios.stop();
+		return 0;
+	}
+	if (argc > 1 && 0 == strcmp(argv[1], "--remote"))
+	{
+		int port = argc > 2 ? atoi(argv[2]) : 9100;
+		int count = argc > 3 ? atoi(argv[3]) : 1000;
+		bool ok = false;
+		actor_handle actorRemote = my_actor::create(boost_strand::create(ios), boost::bind(&remote_test, _1, (size_t)(port > 0 ? port : 9100), count > 0 ? count : 1000, &ok));
+		actorRemote->notify_run();
+		actorRemote->outside_wait_quit();
+		ios.stop();
+		return ok ? 0 : 1;
+	}
 	{
 		actor_handle actorTest = my_actor::create(boost_strand::create(ios), boost::bind(&actor_test, _1));
 		actorTest->notify_run();
@@ -1,9 +1,11 @@
 #include "acceptor_socket.h"
 #include "scattered.h"
+#include <assert.h>
 
 acceptor_socket::acceptor_socket()
 {
 	_acceptor = NULL;
+	_shardCount = 0;
 }
 
 acceptor_socket::~acceptor_socket()
@@ -23,13 +25,38 @@ accept_handle acceptor_socket::create(shared_strand strand, size_t port, const s
 		return shared_accept;
 	}
 	catch (...)
-	{//acceptor쳣
+	{//acceptor构造异常
+		return accept_handle();
+	}
+}
+
+accept_handle acceptor_socket::create(const std::vector<shared_strand>& strands, size_t port, const std::function<void(shared_strand, socket_handle)>& h, bool reuse)
+{
+	assert(!strands.empty());
+	try
+	{
+		accept_handle shared_accept(new acceptor_socket());
+		shared_accept->_acceptor = new boost::asio::ip::tcp::acceptor(strands.front()->get_io_service(),
+			boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), (unsigned short)port), reuse);
+		shared_accept->_shardH = h;
+		shared_accept->_shards = strands;
+		shared_accept->_shardCount = strands.size();
+		boost::lock_guard<boost::mutex> lg(shared_accept->_acceptMutex);
+		for (size_t i = 0; i < strands.size(); i++)
+		{
+			shared_accept->shard_run(shared_accept, i);
+		}
+		return shared_accept;
+	}
+	catch (...)
+	{//acceptor构造异常
 		return accept_handle();
 	}
 }
 
 void acceptor_socket::close()
 {
+	boost::lock_guard<boost::mutex> lg(_acceptMutex);
 	boost::system::error_code ec;
 	_acceptor->close(ec);
 }
@@ -53,4 +80,36 @@ void acceptor_socket::acceptor_run(accept_handle shared_this)
 			clear_function(shared_this->_h);
 		}
 	});
-}
\ No newline at end of file
+}
+
+void acceptor_socket::shard_run(accept_handle shared_this, size_t i)
+{
+	//调用前已锁定_acceptMutex，多个分片在不同线程中重新发起accept；
+	//完成回调在监听socket的io_service中触发，经wrap投递到分片strand
+	shared_strand strand = _shards[i];
+	socket_handle newSocket = socket_io::create(strand->get_io_service());
+	_acceptor->async_accept((boost::asio::ip::tcp::socket&)*newSocket, strand->wrap([newSocket, shared_this, strand, i]
+		(const boost::system::error_code& err)
+	{
+		if (!err)
+		{
+			newSocket->ip();
+			shared_this->_shardH(strand, newSocket);
+			boost::lock_guard<boost::mutex> lg(shared_this->_acceptMutex);
+			if (shared_this->_acceptor->is_open())
+			{
+				shared_this->shard_run(shared_this, i);
+				return;
+			}
+		}
+		else
+		{
+			shared_this->close();
+		}
+		if (0 == --shared_this->_shardCount)
+		{
+			shared_this->_shardH(strand, socket_handle());
+			clear_function(shared_this->_shardH);
+		}
+	}));
+}
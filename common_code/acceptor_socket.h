@@ -4,6 +4,9 @@
 #include "socket_io.h"
 #include "shared_strand.h"
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/atomic/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <vector>
 
 class acceptor_socket;
 typedef std::shared_ptr<acceptor_socket> accept_handle;
@@ -15,13 +18,28 @@ private:
 public:
 	~acceptor_socket();
 	static accept_handle create(shared_strand  strand, size_t port, const std::function<void(socket_handle)>& h, bool reuse = true);
+
+	/*!
+	@brief 分片监听，同一个监听端口上为每个strand各挂一个等待中的accept(IOCP下即多个AcceptEx)，
+	新连接创建在所属strand的io_service上，之后的读写都在该io_service中完成；
+	Windows下一个监听socket只能关联一个完成端口，accept本身仍在第一个strand的io_service中完成，
+	再投递一次到所属strand中回调
+	@param strands 服务新连接的strand组，可以来自不同的ios_proxy
+	@param h 新连接回调(所属strand, 连接)，监听关闭时在最后退出的分片中回调一次空连接
+	*/
+	static accept_handle create(const std::vector<shared_strand>& strands, size_t port, const std::function<void(shared_strand, socket_handle)>& h, bool reuse = true);
 public:
 	void close();
 private:
 	void acceptor_run(accept_handle shared_this);
+	void shard_run(accept_handle shared_this, size_t i);
 private:
 	boost::asio::ip::tcp::acceptor* _acceptor;
 	std::function<void(socket_handle)> _h;
+	std::function<void(shared_strand, socket_handle)> _shardH;
+	std::vector<shared_strand> _shards;
+	boost::atomic<size_t> _shardCount;
+	boost::mutex _acceptMutex;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,490 @@
+#include "actor_bench.h"
+#include "actor_mutex.h"
+#include "shared_data.h"
+#include "scattered.h"
+#include "actor_trace.h"
+#include <algorithm>
+#include <stdio.h>
+
+#ifdef _DEBUG
+#define BENCH_STACK_SIZE	DEFAULT_STACKSIZE
+#else
+#define BENCH_STACK_SIZE	(16 kB)
+#endif
+
+actor_bench::actor_bench(ios_proxy& ios, int rounds, int batch)
+:_ios(ios), _filter(NULL), _rounds(rounds), _batch(batch)
+{
+	assert(rounds > 0 && batch > 0);
+	_strands.resize(ios.threadNumber() > 1 ? ios.threadNumber() : 2);
+	for (size_t i = 0; i < _strands.size(); i++)
+	{
+		_strands[i] = boost_strand::create(ios);
+	}
+}
+
+void actor_bench::run(my_actor* self, const char* filter)
+{
+	_filter = filter;
+	int threads = (int)_ios.threadNumber();
+	bench_switch(self, 1);
+	bench_switch(self, threads);
+	bench_switch(self, threads * 64);
+	bench_create(self);
+	bench_ping_pong(self, false);
+	bench_ping_pong(self, true);
+	bench_pump_ping_pong(self, false);
+	bench_pump_ping_pong(self, true);
+	bench_fan_in(self, threads);
+	bench_fan_in(self, threads * 16);
+	bench_fan_out(self, threads);
+	bench_fan_out(self, threads * 16);
+	bench_timer(self);
+	bench_mutex(self, 1);
+	bench_mutex(self, threads);
+	bench_msg_data(self, 64);
+	bench_msg_data(self, 4 kB);
+	bench_msg_data(self, 256 kB);
+	bench_trace_record(self);//会启用跟踪，放在最后
+	_filter = NULL;
+}
+
+const std::vector<bench_result>& actor_bench::results()
+{
+	return _results;
+}
+
+std::string actor_bench::json()
+{
+	std::string res;
+	char buf[512];
+	sprintf_s(buf, "{\n\t\"threads\": %d,\n\t\"rounds\": %d,\n\t\"batch\": %d,\n\t\"unit\": \"ns\",\n\t\"cases\": [", (int)_ios.threadNumber(), _rounds, _batch);
+	res += buf;
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		const bench_result& r = _results[i];
+		sprintf_s(buf, "%s\n\t\t{\"name\": \"%s\", \"params\": %s, \"samples\": %d, \"ops\": %lld, \"ops_per_sec\": %.1f, "
+			"\"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}",
+			i ? "," : "", r._name.c_str(), r._params.c_str(), (int)r._samples, r._ops, r._opsPerSec, r._mean, r._p50, r._p90, r._p99, r._max);
+		res += buf;
+	}
+	res += "\n\t]\n}\n";
+	return res;
+}
+
+bool actor_bench::enabled(const char* name)
+{
+	if (!_filter || !_filter[0])
+	{
+		return true;
+	}
+	//整个名称相同，或者是以 _ 分隔的前缀(fan 匹配 fan_in/fan_out，ping_pong 不匹配 pump_ping_pong)
+	size_t n = strlen(_filter);
+	return 0 == strncmp(name, _filter, n) && ('\0' == name[n] || '_' == name[n]);
+}
+
+void actor_bench::add(const char* name, const char* params, std::vector<double>& samples, long long ops, long long totalUs)
+{
+	assert(!samples.empty());
+	std::sort(samples.begin(), samples.end());
+	bench_result r;
+	r._name = name;
+	r._params = params;
+	r._samples = samples.size();
+	r._ops = ops;
+	r._opsPerSec = totalUs > 0 ? (double)ops * 1000000 / totalUs : 0;
+	double sum = 0;
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		sum += samples[i];
+	}
+	r._mean = sum / samples.size();
+	r._p50 = samples[(samples.size() - 1) * 50 / 100];
+	r._p90 = samples[(samples.size() - 1) * 90 / 100];
+	r._p99 = samples[(samples.size() - 1) * 99 / 100];
+	r._max = samples.back();
+	_results.push_back(r);
+}
+
+void actor_bench::bench_switch(my_actor* self, int actors)
+{//上下文切换频率，actors 个Actor分布在各strand上，每个 sleep(0) batch 次
+	if (!enabled("switch"))
+	{
+		return;
+	}
+	std::vector<double> samples;
+	long long totalUs = 0;
+	int batch = _batch;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		list<child_actor_handle::ptr> childList;
+		for (int i = 0; i < actors; i++)
+		{
+			auto newActor = child_actor_handle::make_ptr();
+			*newActor = self->create_child_actor(_strands[i % _strands.size()], [batch](my_actor* self)
+			{
+				for (int j = 0; j < batch; j++)
+				{
+					self->sleep(0);
+				}
+			}, BENCH_STACK_SIZE);
+			childList.push_back(newActor);
+		}
+		long long tk = get_tick_us();
+		self->child_actor_run(childList);
+		self->child_actors_wait_quit(childList);
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / ((long long)actors * batch));
+	}
+	char params[64];
+	sprintf_s(params, "{\"actors\": %d}", actors);
+	add("switch", params, samples, (long long)_rounds * actors * batch, totalUs);
+}
+
+void actor_bench::bench_create(my_actor* self)
+{//创建、运行、等待退出一个空Actor
+	if (!enabled("create_destroy"))
+	{
+		return;
+	}
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < _batch; i++)
+		{
+			child_actor_handle ch = self->create_child_actor([](my_actor*){}, BENCH_STACK_SIZE);
+			self->child_actor_run(ch);
+			self->child_actor_wait_quit(ch);
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / _batch);
+	}
+	add("create_destroy", "{}", samples, (long long)_rounds * _batch, totalUs);
+}
+
+void actor_bench::bench_ping_pong(my_actor* self, bool crossStrand)
+{//通过 actor_msg_handle 往返一个消息
+	if (!enabled("ping_pong"))
+	{
+		return;
+	}
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	std::function<void (int)> toBuddy;
+	std::function<void (int)>* buddySlot = &toBuddy;
+	shared_strand strand = crossStrand ? _strands[1] : self->self_strand();
+	child_actor_handle buddy = self->create_child_actor(strand, [toSelf, buddySlot](my_actor* self)
+	{
+		actor_msg_handle<int> amh;
+		*buddySlot = self->make_msg_notifer(amh);
+		toSelf(-1);
+		while (true)
+		{
+			int i = self->wait_msg(amh);
+			if (i < 0)
+			{
+				break;
+			}
+			toSelf(i);
+		}
+		self->close_msg_notifer(amh);
+	}, BENCH_STACK_SIZE);
+	self->child_actor_run(buddy);
+	self->wait_msg(amh);
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < _batch; i++)
+		{
+			toBuddy(i);
+			self->wait_msg(amh);
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / _batch);
+	}
+	toBuddy(-1);
+	self->child_actor_wait_quit(buddy);
+	self->close_msg_notifer(amh);
+	add("ping_pong", crossStrand ? "{\"strand\": \"cross\"}" : "{\"strand\": \"same\"}", samples, (long long)_rounds * _batch, totalUs);
+}
+
+void actor_bench::bench_pump_ping_pong(my_actor* self, bool crossStrand)
+{//通过 post_actor_msg/msg_pump 发过去，actor_msg_handle 回来
+	if (!enabled("pump_ping_pong"))
+	{
+		return;
+	}
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	shared_strand strand = crossStrand ? _strands[1] : self->self_strand();
+	child_actor_handle buddy = self->create_child_actor(strand, [toSelf](my_actor* self)
+	{
+		auto pump = self->connect_msg_pump<int>();
+		while (true)
+		{
+			int i = 0;
+			self->pump_msg(pump, i);
+			if (i < 0)
+			{
+				break;
+			}
+			toSelf(i);
+		}
+	}, BENCH_STACK_SIZE);
+	self->child_actor_run(buddy);
+	auto toBuddy = self->connect_msg_notifer_to<int>(buddy);
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < _batch; i++)
+		{
+			toBuddy(i);
+			self->wait_msg(amh);
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / _batch);
+	}
+	toBuddy(-1);
+	self->child_actor_wait_quit(buddy);
+	self->close_msg_notifer(amh);
+	add("pump_ping_pong", crossStrand ? "{\"strand\": \"cross\"}" : "{\"strand\": \"same\"}", samples, (long long)_rounds * _batch, totalUs);
+}
+
+void actor_bench::bench_fan_in(my_actor* self, int producers)
+{//producers 个Actor各发 batch 个消息给一个接收者
+	if (!enabled("fan_in"))
+	{
+		return;
+	}
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	std::vector<double> samples;
+	long long totalUs = 0;
+	int batch = _batch;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		list<child_actor_handle::ptr> childList;
+		for (int i = 0; i < producers; i++)
+		{
+			auto newActor = child_actor_handle::make_ptr();
+			*newActor = self->create_child_actor(_strands[i % _strands.size()], [toSelf, batch](my_actor* self)
+			{
+				for (int j = 0; j < batch; j++)
+				{
+					toSelf(j);
+				}
+			}, BENCH_STACK_SIZE);
+			childList.push_back(newActor);
+		}
+		long long tk = get_tick_us();
+		self->child_actor_run(childList);
+		for (long long n = (long long)producers * batch; n > 0; n--)
+		{
+			self->wait_msg(amh);
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / ((long long)producers * batch));
+		self->child_actors_wait_quit(childList);
+	}
+	self->close_msg_notifer(amh);
+	char params[64];
+	sprintf_s(params, "{\"producers\": %d}", producers);
+	add("fan_in", params, samples, (long long)_rounds * producers * batch, totalUs);
+}
+
+void actor_bench::bench_fan_out(my_actor* self, int consumers)
+{//一个发送者给 consumers 个Actor各发 batch 个消息，都收完后结束
+	if (!enabled("fan_out"))
+	{
+		return;
+	}
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	int batch = _batch;
+	list<child_actor_handle::ptr> childList;
+	std::vector<post_actor_msg<int> > writers;
+	for (int i = 0; i < consumers; i++)
+	{
+		auto newActor = child_actor_handle::make_ptr();
+		*newActor = self->create_child_actor(_strands[i % _strands.size()], [toSelf, batch](my_actor* self)
+		{
+			auto pump = self->connect_msg_pump<int>();
+			while (true)
+			{
+				int i = 0;
+				self->pump_msg(pump, i);
+				if (i < 0)
+				{
+					break;
+				}
+				if (batch - 1 == i)
+				{
+					toSelf(i);
+				}
+			}
+		}, BENCH_STACK_SIZE);
+		childList.push_back(newActor);
+		self->child_actor_run(*newActor);
+		writers.push_back(self->connect_msg_notifer_to<int>(*newActor));
+	}
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int j = 0; j < batch; j++)
+		{
+			for (int i = 0; i < consumers; i++)
+			{
+				writers[i](j);
+			}
+		}
+		for (int i = 0; i < consumers; i++)
+		{
+			self->wait_msg(amh);
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / ((long long)consumers * batch));
+	}
+	for (int i = 0; i < consumers; i++)
+	{
+		writers[i](-1);
+	}
+	self->child_actors_wait_quit(childList);
+	self->close_msg_notifer(amh);
+	char params[64];
+	sprintf_s(params, "{\"consumers\": %d}", consumers);
+	add("fan_out", params, samples, (long long)_rounds * consumers * batch, totalUs);
+}
+
+void actor_bench::bench_timer(my_actor* self)
+{//启动并取消一次内部定时器
+	if (!enabled("timer_arm_cancel"))
+	{
+		return;
+	}
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < _batch; i++)
+		{
+			self->delay_trig(1000, []{});
+			self->cancel_delay_trig();
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / _batch);
+	}
+	add("timer_arm_cancel", "{}", samples, (long long)_rounds * _batch, totalUs);
+}
+
+void actor_bench::bench_mutex(my_actor* self, int actors)
+{//actors 个Actor分布在各strand上争用同一个 actor_mutex
+	if (!enabled("mutex_lock_unlock"))
+	{
+		return;
+	}
+	actor_mutex amutex(self->self_strand());
+	std::vector<double> samples;
+	long long totalUs = 0;
+	int batch = _batch;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		list<child_actor_handle::ptr> childList;
+		for (int i = 0; i < actors; i++)
+		{
+			auto newActor = child_actor_handle::make_ptr();
+			*newActor = self->create_child_actor(_strands[i % _strands.size()], [amutex, batch](my_actor* self)
+			{
+				for (int j = 0; j < batch; j++)
+				{
+					amutex.lock(self);
+					amutex.unlock(self);
+				}
+			}, BENCH_STACK_SIZE);
+			childList.push_back(newActor);
+		}
+		long long tk = get_tick_us();
+		self->child_actor_run(childList);
+		self->child_actors_wait_quit(childList);
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / ((long long)actors * batch));
+	}
+	char params[64];
+	sprintf_s(params, "{\"actors\": %d}", actors);
+	add("mutex_lock_unlock", params, samples, (long long)_rounds * actors * batch, totalUs);
+}
+
+void actor_bench::bench_msg_data(my_actor* self, size_t size)
+{//分配并释放一个 msg_data
+	if (!enabled("msg_data_alloc"))
+	{
+		return;
+	}
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < _batch; i++)
+		{
+			shared_data msg = msg_data::create(size);
+			((char*)msg->data())[0] = (char)i;
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / _batch);
+		self->sleep(0);
+	}
+	char params[64];
+	sprintf_s(params, "{\"size\": %d}", (int)size);
+	add("msg_data_alloc", params, samples, (long long)_rounds * _batch, totalUs);
+}
+
+void actor_bench::bench_trace_record(my_actor* self)
+{//actor_trace 记录一个事件，没有启用跟踪时先启用，结束后暂停
+	if (!enabled("trace_record"))
+	{
+		return;
+	}
+	bool wasEnabled = actor_trace::enabled();
+	if (!wasEnabled)
+	{
+		actor_trace::enable();
+	}
+	actor_trace::pause(false);
+	std::vector<double> samples;
+	long long totalUs = 0;
+	for (int rd = 0; rd < _rounds; rd++)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < _batch; i++)
+		{
+			actor_trace::record(trace_msg_send, self->self_id(), i);
+		}
+		long long dt = get_tick_us() - tk;
+		totalUs += dt;
+		samples.push_back((double)dt * 1000 / _batch);
+		self->sleep(0);
+	}
+	if (!wasEnabled)
+	{
+		actor_trace::pause(true);
+	}
+	add("trace_record", "{}", samples, (long long)_rounds * _batch, totalUs);
+}
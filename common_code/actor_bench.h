@@ -0,0 +1,70 @@
+#ifndef __ACTOR_BENCH_H
+#define __ACTOR_BENCH_H
+
+#include "actor_framework.h"
+#include "ios_proxy.h"
+#include <string>
+#include <vector>
+
+/*!
+@brief 一个基准测试用例的结果，耗时单位为纳秒/次
+*/
+struct bench_result
+{
+	std::string _name;
+	std::string _params;///<JSON对象格式的用例参数
+	size_t _samples;
+	long long _ops;
+	double _opsPerSec;
+	double _mean;
+	double _p50;
+	double _p90;
+	double _p99;
+	double _max;
+};
+
+/*!
+@brief Actor运行时微基准测试，每个用例重复 rounds 轮，每轮执行 batch 次操作记为一个采样，
+统计单次耗时的分位数，结果输出为JSON，便于不同版本间对比
+*/
+class actor_bench
+{
+public:
+	/*!
+	@param ios 运行测试的调度器，跨strand用例在它的每个线程上各建一个strand
+	*/
+	actor_bench(ios_proxy& ios, int rounds = 100, int batch = 1000);
+public:
+	/*!
+	@brief 运行名称等于 filter 或以 filter_ 开头的用例，filter 为空时全部运行
+	*/
+	void run(my_actor* self, const char* filter = NULL);
+
+	/*!
+	@brief 已运行用例的JSON报告
+	*/
+	std::string json();
+	const std::vector<bench_result>& results();
+private:
+	bool enabled(const char* name);
+	void add(const char* name, const char* params, std::vector<double>& samples, long long ops, long long totalUs);
+	void bench_switch(my_actor* self, int actors);
+	void bench_create(my_actor* self);
+	void bench_ping_pong(my_actor* self, bool crossStrand);
+	void bench_pump_ping_pong(my_actor* self, bool crossStrand);
+	void bench_fan_in(my_actor* self, int producers);
+	void bench_fan_out(my_actor* self, int consumers);
+	void bench_timer(my_actor* self);
+	void bench_mutex(my_actor* self, int actors);
+	void bench_msg_data(my_actor* self, size_t size);
+	void bench_trace_record(my_actor* self);
+private:
+	ios_proxy& _ios;
+	std::vector<shared_strand> _strands;
+	std::vector<bench_result> _results;
+	const char* _filter;
+	int _rounds;
+	int _batch;
+};
+
+#endif
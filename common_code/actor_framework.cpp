@@ -6,6 +6,8 @@
 #include "actor_stack.h"
 #include "scattered.h"
 #include "wrapped_no_params_handler.h"
+#include <map>
+#include <stdio.h>
 
 typedef boost::coroutines::coroutine<void>::pull_type actor_pull_type;
 typedef boost::coroutines::coroutine<void>::push_type actor_push_type;
@@ -27,13 +29,41 @@ typedef boost::asio::basic_waitable_timer<boost::chrono::high_resolution_clock>
 
 #endif //end _DEBUG
 
-//ջԤռ䣬ֹջ
+//堆栈底预留空间，防止爆栈
 #define STACK_RESERVED_SPACE_SIZE		64
-//ڴ߽
+//内存边界对齐
 #define MEM_ALIGN(__o, __a) (((__o) + ((__a)-1)) & (((__a)-1) ^ -1))
 
+bool _actorTreeEnabled = false;
+boost::mutex _rootActorMutex;
+std::map<long long, std::weak_ptr<my_actor> > _rootActors;//没有父Actor的Actor，启用 enable_actor_tree 时登记
+
+//栈使用量统计时填充的字节
+#define STACK_PROFILE_FILL	0xA5
+
+struct stack_profile_stat
+{
+	stack_profile_stat()
+	:_maxUsed(0) {}
+
+	metric_histogram _used;
+	size_t _maxUsed;
+};
+
+bool _stackProfileEnabled = false;
+boost::mutex _stackProfileMutex;
+std::map<std::string, std::shared_ptr<stack_profile_stat> > _stackProfiles;
+
+static void stack_profile_fill(void* sp, size_t size)
+{
+	if (_stackProfileEnabled)
+	{
+		memset((char*)sp - size, STACK_PROFILE_FILL, size);
+	}
+}
+
 /*!
-@brief Actorջ
+@brief Actor栈分配器
 */
 struct actor_stack_pool_allocate
 {
@@ -48,6 +78,7 @@ struct actor_stack_pool_allocate
 	void allocate( boost::coroutines::stack_context & stackCon, size_t size)
 	{
 		stackCon = _stack;
+		stack_profile_fill(stackCon.sp, stackCon.size);
 	}
 
 	void deallocate( boost::coroutines::stack_context & stackCon)
@@ -72,6 +103,7 @@ struct actor_stack_allocate
 	{
 		boost::coroutines::stack_allocator all;
 		all.allocate(stackCon, size);
+		stack_profile_fill(stackCon.sp, stackCon.size);
 		*_sp = stackCon.sp;
 		*_size = stackCon.size;
 	}
@@ -117,7 +149,7 @@ child_actor_handle::child_actor_param& child_actor_handle::child_actor_param::op
 
 child_actor_handle::child_actor_param::~child_actor_param()
 {
-	assert(_isCopy);//ⴴûнActor
+	assert(_isCopy);//检测创建后有没有接收子Actor句柄
 }
 
 child_actor_handle::child_actor_param::child_actor_param( child_actor_handle::child_actor_param& s )
@@ -162,7 +194,7 @@ child_actor_handle& child_actor_handle::operator=( child_actor_param& s )
 	_norQuit = false;
 	_param = s;
 	DEBUG_OPERATION(_param._isCopy = true);
-	DEBUG_OPERATION(_qh = s._actor->parent_actor()->regist_quit_handler([this](){_quited = true;}));//ڸActor˳ʱ_quited=true
+	DEBUG_OPERATION(_qh = s._actor->parent_actor()->regist_quit_handler([this](){_quited = true;}));//在父Actor退出时置_quited=true
 	return *this;
 }
 
@@ -234,6 +266,21 @@ void actor_msg_handle_base::set_actor(const actor_handle& hostActor)
 {
 	_hostActor = hostActor;
 	_strand = hostActor->self_strand();
+	if (_actorTreeEnabled)
+	{
+		boost::lock_guard<boost::mutex> lg(_hostActor->_msgHandleMutex);
+		_hostActor->_msgHandleList.push_back(this);
+	}
+}
+
+void actor_msg_handle_base::reset_actor()
+{
+	if (_actorTreeEnabled && _hostActor)
+	{
+		boost::lock_guard<boost::mutex> lg(_hostActor->_msgHandleMutex);
+		_hostActor->_msgHandleList.remove(this);
+	}
+	_hostActor.reset();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -272,6 +319,7 @@ msg_pool_void::pump_handler msg_pool_void::connect_pump(const std::shared_ptr<ms
 
 void msg_pool_void::push_msg()
 {
+	RUNTIME_METRIC(_mailboxPushed.add());
 	if (_strand->running_in_this_thread())
 	{
 		send_msg(true);
@@ -279,8 +327,15 @@ void msg_pool_void::push_msg()
 	else
 	{
 		auto shared_this = _weakThis.lock();
+		unsigned long long flow = actor_trace::msg_send(0);
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
+			actor_trace::msg_recv(0, flow);
+			if (sendCycle)
+			{
+				wake_latency::on_push(shared_this->_strand.get(), wake_latency::pump_mailbox, sendCycle);
+			}
 			shared_this->send_msg(false);
 		});
 	}
@@ -357,7 +412,7 @@ void msg_pool_void::pump_handler::operator()(BYTE pumpID)
 				}
 			}
 			else
-			{//ϴϢûȡȡʵмѾpostȥ
+			{//上次消息没取到，重新取，但实际中间已经post出去了
 				assert(!_thisPool->_waiting);
 				assert(pumpID + 1 == _thisPool->_sendCount);
 			}
@@ -533,8 +588,9 @@ struct my_actor::timer_pck
 	std::function<void ()> _h;
 };
 
-boost::atomic<long long> _actorIDCount(0);//ID
+boost::atomic<long long> _actorIDCount(0);//ID计数
 bool _autoMakeTimer = true;
+bool _cpuStatEnabled = false;
 
 class my_actor::boost_actor_run
 {
@@ -563,7 +619,7 @@ public:
 			assert(_actor._suspendResumeQueue.empty());
 		}
 		catch (my_actor::force_quit_exception&)
-		{//Actorǿ˳쳣
+		{//捕获Actor被强制退出异常
 			assert(!_actor._inActor);
 		}
 #ifdef _DEBUG
@@ -576,7 +632,12 @@ public:
 			assert(false);
 		}
 #endif
+		if (_stackProfileEnabled)
+		{
+			_actor.stack_profile_record();
+		}
 		clear_function(_actor._mainFunc);
+		RUNTIME_METRIC(_actorExited.add());
 		_actor._msgPoolStatus.clear();
 		while (!_actor._exitCallback.empty())
 		{
@@ -608,10 +669,18 @@ my_actor::my_actor()
 	_lockQuit = 0;
 	_stackTop = NULL;
 	_stackSize = 0;
+	_stackTag = NULL;
+	_isRootActor = false;
 	_yieldCount = 0;
+	_yieldReason = yield_other;
+	_yieldCycle = 0;
+	_yieldStackFree = 0;
+	_minStackFree = (size_t)-1;
 	_childOverCount = 0;
 	_childSuspendResumeCount = 0;
 	_selfID = ++_actorIDCount;
+	RUNTIME_METRIC(_actorCreated.add());
+	RUNTIME_METRIC(_actorAlive.add());
 }
 
 my_actor::my_actor(const my_actor&)
@@ -621,6 +690,12 @@ my_actor::my_actor(const my_actor&)
 
 my_actor::~my_actor()
 {
+	RUNTIME_METRIC(_actorAlive.sub());
+	if (_isRootActor)
+	{
+		boost::lock_guard<boost::mutex> lg(_rootActorMutex);
+		_rootActors.erase(_selfID);
+	}
 	assert(_quited);
 	assert(!_mainFunc);
 	assert(!_childOverCount);
@@ -647,7 +722,7 @@ my_actor::~my_actor()
 	{
 		assert(false);
 		char buf[48];
-		sprintf_s(buf, "%llu Actorջ", _selfID);
+		sprintf_s(buf, "%llu Actor堆栈溢出", _selfID);
 		throw std::shared_ptr<string>(new string(buf));
 	}
 #endif
@@ -667,6 +742,23 @@ actor_handle my_actor::create( shared_strand actorStrand, const main_func& mainF
 actor_handle my_actor::create( shared_strand actorStrand, const main_func& mainFunc,
 	const std::function<void (bool)>& cb, size_t stackSize )
 {
+	actor_handle newActor = create_(actorStrand, mainFunc, cb, stackSize);
+	if (_actorTreeEnabled)
+	{
+		newActor->_isRootActor = true;
+		boost::lock_guard<boost::mutex> lg(_rootActorMutex);
+		_rootActors[newActor->_selfID] = newActor;
+	}
+	return newActor;
+}
+
+actor_handle my_actor::create_( shared_strand actorStrand, const main_func& mainFunc,
+	const std::function<void (bool)>& cb, size_t stackSize )
+{
+	if (AUTO_STACKSIZE == stackSize)
+	{
+		stackSize = auto_stack_size(mainFunc.target_type().name());
+	}
 	assert(stackSize && stackSize <= 1024 kB && 0 == stackSize % (4 kB));
 	actor_handle newActor;
 	if (actor_stack_pool::isEnable())
@@ -704,6 +796,10 @@ actor_handle my_actor::create( shared_strand actorStrand, const main_func& mainF
 			boost::coroutines::attributes(stackSize), actor_stack_allocate(&newActor->_stackTop, &newActor->_stackSize));
 	}
 	newActor->_weakThis = newActor;
+	if (_stackProfileEnabled)
+	{
+		newActor->_stackTag = mainFunc.target_type().name();
+	}
 #if (CHECK_ACTOR_STACK) || (_DEBUG)
 	*(long long*)((BYTE*)newActor->_stackTop-newActor->_stackSize+STACK_RESERVED_SPACE_SIZE-sizeof(long long)) = 0xFEFEFEFEFEFEFEFE;
 #endif
@@ -732,7 +828,7 @@ child_actor_handle::child_actor_param my_actor::create_child_actor( shared_stran
 {
 	assert_enter();
 	child_actor_handle::child_actor_param actorHandle;
-	actorHandle._actor = my_actor::create(actorStrand, mainFunc, stackSize);
+	actorHandle._actor = my_actor::create_(actorStrand, mainFunc, std::function<void (bool)>(), stackSize);
 	actorHandle._actor->_parentActor = shared_from_this();
 	_childActorList.push_front(actorHandle._actor);
 	actorHandle._actorIt = _childActorList.begin();
@@ -972,6 +1068,7 @@ void my_actor::sleep( int ms )
 	assert_enter();
 	actor_handle shared_this = shared_from_this();
 	delay_trig(ms, [shared_this](){shared_this->run_one(); });
+	_yieldReason = yield_for_timer;
 	push_yield();
 }
 
@@ -988,7 +1085,7 @@ const list<actor_handle>& my_actor::child_actors()
 my_actor::quit_iterator my_actor::regist_quit_handler( const std::function<void ()>& quitHandler )
 {
 	assert_enter();
-	_quitHandlerList.push_front(quitHandler);//עִ
+	_quitHandlerList.push_front(quitHandler);//后注册的先执行
 	return _quitHandlerList.begin();
 }
 
@@ -1037,6 +1134,12 @@ void my_actor::reset_yield()
 	_yieldCount = 0;
 }
 
+actor_cpu_stat my_actor::cpu_stat()
+{
+	assert(_strand->running_in_this_thread());
+	return _cpuStat;
+}
+
 void my_actor::notify_run()
 {
 	actor_handle shared_this = shared_from_this();
@@ -1525,7 +1628,70 @@ void my_actor::pull_yield()
 	assert(!_quited);
 	if (!_suspended)
 	{
-		(*(actor_pull_type*)_actorPull)();
+		if (!_cpuStatEnabled && !actor_trace::enabled() && !ios_proxy::watching())
+		{
+			(*(actor_pull_type*)_actorPull)();
+			return;
+		}
+		bool watching = ios_proxy::watching();
+		bool watchOuter = false;
+		ios_proxy::watch_mark watchMark = { 0, NULL };
+		if (watching)
+		{
+			watchOuter = ios_proxy::watchBegin();
+			watchMark = ios_proxy::watchActor(_selfID, _strand.get());
+		}
+		if (!_cpuStatEnabled)
+		{
+			actor_trace::record(trace_actor_resume, _selfID);
+			(*(actor_pull_type*)_actorPull)();
+			actor_trace::record(trace_actor_yield, _selfID);
+		}
+		else
+		{
+			actor_cpu_stat& strandStat = _strand->_cpuStat;
+			unsigned long long beginCycle = get_cycle();
+			if (_yieldCycle)
+			{//上次让出到这次恢复之间的等待时间
+				unsigned long long waitCycles = beginCycle - _yieldCycle;
+				if (yield_for_msg == _yieldReason)
+				{
+					_cpuStat._msgWaitCycles += waitCycles;
+					strandStat._msgWaitCycles += waitCycles;
+				}
+				else if (yield_for_timer == _yieldReason)
+				{
+					_cpuStat._timerWaitCycles += waitCycles;
+					strandStat._timerWaitCycles += waitCycles;
+				}
+			}
+			_yieldReason = yield_other;
+			actor_trace::record(trace_actor_resume, _selfID);
+			(*(actor_pull_type*)_actorPull)();
+			actor_trace::record(trace_actor_yield, _selfID);
+			_yieldCycle = get_cycle();
+			unsigned long long sliceCycles = _yieldCycle - beginCycle;
+			_cpuStat._runCycles += sliceCycles;
+			_cpuStat._resumeCount++;
+			strandStat._runCycles += sliceCycles;
+			strandStat._resumeCount++;
+			if (sliceCycles > _cpuStat._maxSliceCycles)
+			{
+				_cpuStat._maxSliceCycles = sliceCycles;
+			}
+			if (sliceCycles > strandStat._maxSliceCycles)
+			{
+				strandStat._maxSliceCycles = sliceCycles;
+			}
+		}
+		if (watching)
+		{
+			ios_proxy::watchRestore(watchMark);
+			if (watchOuter)
+			{
+				ios_proxy::watchEnd();
+			}
+		}
 	}
 	else
 	{
@@ -1540,7 +1706,16 @@ void my_actor::push_yield()
 	assert(_inActor);
 	_yieldCount++;
 	DEBUG_OPERATION(_inActor = false);
+	if (_actorTreeEnabled)
+	{
+		_yieldStackFree = stack_free_space();
+		if (_yieldStackFree < _minStackFree)
+		{
+			_minStackFree = _yieldStackFree;
+		}
+	}
 	(*(actor_push_type*)_actorPush)();
+	_yieldReason = yield_other;
 	if (!_quited)
 	{
 		DEBUG_OPERATION(_inActor = true);
@@ -1653,6 +1828,7 @@ void my_actor::expires_timer()
 		{
 			assert(!timer->_timerSuspend && !timer->_timerCompleted);
 			timer->_timerCompleted = true;
+			actor_trace::record(trace_timer_fire, shared_this->_selfID);
 			std::function<void()> h;
 			timer->_h.swap(h);
 			h();
@@ -1731,13 +1907,271 @@ void my_actor::disable_auto_make_timer()
 	_autoMakeTimer = false;
 }
 
+void my_actor::enable_cpu_stat()
+{
+	assert(0 == _actorIDCount);
+	calibrate_cycle();
+	_cpuStatEnabled = true;
+}
+
+struct my_actor::snapshot_walk
+{
+	void done()
+	{
+		if (1 == _pending--)
+		{
+			_h(_roots);
+		}
+	}
+
+	boost::atomic<size_t> _pending;
+	std::shared_ptr<std::vector<actor_snapshot> > _roots;
+	std::function<void (const std::shared_ptr<std::vector<actor_snapshot> >&)> _h;
+};
+
+void my_actor::enable_actor_tree()
+{
+	assert(0 == _actorIDCount);
+	_actorTreeEnabled = true;
+}
+
+void my_actor::snapshot_tree(const std::function<void (const std::shared_ptr<std::vector<actor_snapshot> >&)>& h)
+{
+	assert(_actorTreeEnabled);
+	std::vector<actor_handle> roots;
+	{
+		boost::lock_guard<boost::mutex> lg(_rootActorMutex);
+		roots.reserve(_rootActors.size());
+		for (auto it = _rootActors.begin(); it != _rootActors.end(); it++)
+		{
+			actor_handle actor = it->second.lock();
+			if (actor)
+			{
+				roots.push_back(actor);
+			}
+		}
+	}
+	std::shared_ptr<snapshot_walk> walk(new snapshot_walk);
+	walk->_roots = std::shared_ptr<std::vector<actor_snapshot> >(new std::vector<actor_snapshot>(roots.size()));
+	walk->_h = h;
+	if (roots.empty())
+	{
+		h(walk->_roots);
+		return;
+	}
+	walk->_pending = roots.size();
+	for (size_t i = 0; i < roots.size(); i++)
+	{
+		actor_handle actor = roots[i];
+		actor_snapshot* node = &(*walk->_roots)[i];
+		actor->_strand->post([actor, node, walk]()
+		{
+			actor->snapshot_visit(node, 0, walk);
+		});
+	}
+}
+
+void my_actor::snapshot_visit(actor_snapshot* node, long long parentID, const std::shared_ptr<snapshot_walk>& walk)
+{
+	assert(_strand->running_in_this_thread());
+	node->_actorID = _selfID;
+	node->_parentID = parentID;
+	node->_started = _started;
+	node->_quited = _quited;
+	node->_suspended = _suspended;
+	node->_waitFor = actor_snapshot::wait_none;
+	if (_started && !_quited)
+	{
+		if (yield_for_msg == _yieldReason)
+		{
+			node->_waitFor = actor_snapshot::wait_msg;
+		}
+		else if (yield_for_timer == _yieldReason)
+		{
+			node->_waitFor = actor_snapshot::wait_timer;
+		}
+		else if (_yieldCount)
+		{
+			node->_waitFor = actor_snapshot::wait_other;
+		}
+	}
+	node->_stackSize = _stackSize;
+	node->_stackFree = (size_t)-1 == _minStackFree ? _stackSize : _yieldStackFree;
+	node->_stackMinFree = (size_t)-1 == _minStackFree ? _stackSize : _minStackFree;
+	node->_hasTimer = NULL != _timer;
+	node->_timerArmed = _timer && !_timer->_timerCompleted;
+	node->_timerSuspended = _timer && _timer->_timerSuspend;
+	{
+		boost::lock_guard<boost::mutex> lg(_msgHandleMutex);
+		node->_mailboxDepths.reserve(_msgHandleList.size());
+		for (auto it = _msgHandleList.begin(); it != _msgHandleList.end(); it++)
+		{
+			node->_mailboxDepths.push_back((*it)->depth());
+		}
+	}
+	node->_pumpCount = 0;
+	for (int i = 0; i < 5; i++)
+	{
+		node->_pumpCount += _msgPoolStatus._msgPumpList[i].size();
+	}
+	//子Actor可能在其它strand中，各自投递过去填写自己的节点，父节点的_children之后不再改动
+	node->_children.resize(_childActorList.size());
+	walk->_pending += _childActorList.size();
+	size_t i = 0;
+	for (auto it = _childActorList.begin(); it != _childActorList.end(); it++, i++)
+	{
+		actor_handle child = *it;
+		actor_snapshot* childNode = &node->_children[i];
+		long long selfID = _selfID;
+		child->_strand->post([child, childNode, selfID, walk]()
+		{
+			child->snapshot_visit(childNode, selfID, walk);
+		});
+	}
+	walk->done();
+}
+
+void my_actor::set_stack_tag(const char* tag)
+{
+	assert_enter();
+	_stackTag = tag;
+}
+
+void my_actor::enable_stack_profile()
+{
+	assert(0 == _actorIDCount);
+	_stackProfileEnabled = true;
+}
+
+void my_actor::stack_profile_record()
+{
+	//从栈底往上找第一个被改写过的位置，底部预留区不算
+	size_t fill;
+	memset(&fill, STACK_PROFILE_FILL, sizeof(fill));
+	size_t* bottom = (size_t*)((BYTE*)_stackTop - _stackSize + STACK_RESERVED_SPACE_SIZE);
+	size_t* top = (size_t*)_stackTop;
+	size_t* it = bottom;
+	while (it < top && fill == *it)
+	{
+		it++;
+	}
+	size_t used = (size_t)((BYTE*)top - (BYTE*)it);
+	std::string tag(_stackTag ? _stackTag : "unknown");
+	boost::lock_guard<boost::mutex> lg(_stackProfileMutex);
+	std::shared_ptr<stack_profile_stat>& stat = _stackProfiles[tag];
+	if (!stat)
+	{
+		stat = std::shared_ptr<stack_profile_stat>(new stack_profile_stat);
+	}
+	stat->_used.record(used);
+	if (used > stat->_maxUsed)
+	{
+		stat->_maxUsed = used;
+	}
+}
+
+std::vector<actor_stack_profile> my_actor::stack_profile()
+{
+	std::vector<actor_stack_profile> res;
+	boost::lock_guard<boost::mutex> lg(_stackProfileMutex);
+	res.reserve(_stackProfiles.size());
+	for (auto it = _stackProfiles.begin(); it != _stackProfiles.end(); it++)
+	{
+		actor_stack_profile profile;
+		profile._tag = it->first;
+		profile._count = (size_t)it->second->_used.count();
+		profile._p50 = (size_t)it->second->_used.percentile(0.5);
+		profile._p99 = (size_t)it->second->_used.percentile(0.99);
+		profile._maxUsed = it->second->_maxUsed;
+		res.push_back(profile);
+	}
+	return res;
+}
+
+bool my_actor::save_stack_profile(const char* fileName)
+{
+	FILE* file = NULL;
+	if (fopen_s(&file, fileName, "wb") || !file)
+	{
+		return false;
+	}
+	{
+		boost::lock_guard<boost::mutex> lg(_stackProfileMutex);
+		for (auto it = _stackProfiles.begin(); it != _stackProfiles.end(); it++)
+		{//每行：最大使用量<TAB>标签
+			fprintf(file, "%u\t%s\n", (unsigned)it->second->_maxUsed, it->first.c_str());
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+bool my_actor::load_stack_profile(const char* fileName)
+{
+	FILE* file = NULL;
+	if (fopen_s(&file, fileName, "rb") || !file)
+	{
+		return false;
+	}
+	char line[1024];
+	boost::lock_guard<boost::mutex> lg(_stackProfileMutex);
+	while (fgets(line, sizeof(line), file))
+	{
+		char* tab = strchr(line, '\t');
+		if (!tab)
+		{
+			continue;
+		}
+		size_t maxUsed = (size_t)strtoul(line, NULL, 10);
+		char* tagEnd = tab + 1 + strcspn(tab + 1, "\r\n");
+		std::string tag(tab + 1, tagEnd);
+		std::shared_ptr<stack_profile_stat>& stat = _stackProfiles[tag];
+		if (!stat)
+		{
+			stat = std::shared_ptr<stack_profile_stat>(new stack_profile_stat);
+		}
+		if (maxUsed > stat->_maxUsed)
+		{
+			stat->_maxUsed = maxUsed;
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+size_t my_actor::auto_stack_size(const char* tag, double q)
+{
+	size_t used = 0;
+	{
+		boost::lock_guard<boost::mutex> lg(_stackProfileMutex);
+		auto it = _stackProfiles.find(tag);
+		if (it == _stackProfiles.end() || !it->second->_maxUsed)
+		{
+			return DEFAULT_STACKSIZE;
+		}
+		//池中的栈没有保护页，默认按观测到的最大值，只有明确指定 q 时才按分位数
+		used = q < 1 && it->second->_used.count() ? (size_t)it->second->_used.percentile(q) : it->second->_maxUsed;
+	}
+	//余量：观测之外的波动、栈池中Actor对象本身和底部预留区
+	size_t stackSize = MEM_ALIGN(used + used / 4 + 4 kB, 4 kB);
+	if (stackSize < 8 kB)
+	{
+		stackSize = 8 kB;
+	}
+	else if (stackSize > 1024 kB)
+	{
+		stackSize = 1024 kB;
+	}
+	return stackSize;
+}
+
 void my_actor::check_stack()
 {
 #if (CHECK_ACTOR_STACK) || (_DEBUG)
 	if ((size_t)get_sp() < (size_t)_stackTop-_stackSize+STACK_RESERVED_SPACE_SIZE)
 	{
 		assert(false);
-		throw std::shared_ptr<string>(new string("Actorջ쳣"));
+		throw std::shared_ptr<string>(new string("Actor堆栈异常"));
 	}
 #endif
 }
@@ -1813,6 +2247,7 @@ bool my_actor::timed_wait_msg(int tm, actor_msg_handle<>& amh)
 				run_one();
 			});
 		}
+		_yieldReason = yield_for_msg;
 		push_yield();
 		if (!timeout)
 		{
@@ -1852,6 +2287,7 @@ bool my_actor::timed_pump_msg(int tm, const msg_pump<>::handle& pump, bool check
 				}
 			});
 		}
+		_yieldReason = yield_for_msg;
 		push_yield();
 		if (!timeOut)
 		{
@@ -1879,6 +2315,14 @@ void my_actor::wait_msg(actor_msg_handle<>& amh)
 	timed_wait_msg(-1, amh);
 }
 
+bool my_actor::try_wait_msg(actor_msg_handle<>& amh)
+{
+	assert_enter();
+	assert(amh._closed && !(*amh._closed));
+	assert(!amh._waiting);
+	return amh.pop_msg();
+}
+
 void my_actor::pump_msg(const msg_pump<>::handle& pump, bool checkDis)
 {
 	timed_pump_msg(-1, pump, checkDis);
@@ -1910,6 +2354,7 @@ bool my_actor::timed_wait_trig(int tm, actor_trig_handle<>& ath)
 				run_one();
 			});
 		}
+		_yieldReason = yield_for_msg;
 		push_yield();
 		if (!timeout)
 		{
@@ -1,10 +1,10 @@
 /*!
  @header     actor_framework.h
- @abstract   ߼ƿ(Actor Model)ʹ"Э(coroutine)"boost_1.55;
- @discussion һActor(actor_handle)һshared_strand(io_service)ActorԹͬͬһshared_strand;
-             ֧ǿƽ/ָʱ();
-             Actorлio_serviceнгʱĲ㣬Ӱͬһio_serviceActorӦٶ;
-             ĬActorջռ64kֽڣԶ߳ջСעֲռõĿռԼò(עݹ).
+ @abstract   并发逻辑控制框架(Actor Model)，使用"协程(coroutine)"技术，依赖boost_1.55或更新;
+ @discussion 一个Actor对象(actor_handle)依赖一个shared_strand(二级调度器，本身依赖于io_service)，多个Actor可以共同依赖同一个shared_strand;
+             支持强制结束、挂起/恢复、延时、多子任务(并发控制);
+             在Actor中或所依赖的io_service中进行长时间阻塞的操作或重量级运算，会严重影响依赖同一个io_service的Actor响应速度;
+             默认Actor栈空间64k字节，远比线程栈小，注意局部变量占用的空间以及调用层次(注意递归).
  @copyright  Copyright (c) 2015 HAM, E-Mail:591170887@qq.com
  */
 
@@ -13,6 +13,8 @@
 
 #include <boost/circular_buffer.hpp>
 #include <list>
+#include <vector>
+#include <string>
 #include <xutility>
 #include <functional>
 #include "ios_proxy.h"
@@ -21,17 +23,18 @@
 #include "function_type.h"
 #include "msg_queue.h"
 #include "actor_mutex.h"
+#include "actor_metrics.h"
 
 class my_actor;
-typedef std::shared_ptr<my_actor> actor_handle;//Actor
+typedef std::shared_ptr<my_actor> actor_handle;//Actor句柄
 
 using namespace std;
 
-//˺Actorжϱǣʹʱע߼ġԡܻᱻ
+//此函数会进入Actor中断标记，使用时注意逻辑的“连续性”可能会被打破
 #define __yield_interrupt
 
 /*!
-@brief ڼActorڵõĺǷ񴥷ǿ˳
+@brief 用于检测在Actor内调用的函数是否触发了强制退出
 */
 #ifdef _DEBUG
 #define BEGIN_CHECK_FORCE_QUIT try {
@@ -41,7 +44,7 @@ using namespace std;
 #define END_CHECK_FORCE_QUIT
 #endif
 
-// ActorʹãʹActor쳣׽ catch (...) ֮ǰڹActor˳쳣׳Ȼܵ³
+// Actor内使用，在使用了Actor函数的异常捕捉 catch (...) 之前用于过滤Actor退出异常并继续抛出，不然可能导致程序崩溃
 #define CATCH_ACTOR_QUIT()\
 catch (my_actor::force_quit_exception& e)\
 {\
@@ -54,9 +57,11 @@ catch (my_actor::force_quit_exception& e)\
 #define DEBUG_OPERATION(__exp__)
 #endif
 
-//Ĭ϶ջС64k
+//默认堆栈大小64k
 #define kB	*1024
 #define DEFAULT_STACKSIZE	64 kB
+//按历史栈使用统计自动选择栈大小，没有统计数据时就是 DEFAULT_STACKSIZE，见 my_actor::auto_stack_size/load_stack_profile
+#define AUTO_STACKSIZE		0
 
 template <typename T0, typename T1 = void, typename T2 = void, typename T3 = void>
 struct msg_param
@@ -326,9 +331,15 @@ public:
 	virtual ~actor_msg_handle_base(){};
 public:
 	virtual void close() = 0;
+
+	/*!
+	@brief 邮箱中积压的消息数，用于Actor树快照
+	*/
+	virtual size_t depth() = 0;
 protected:
 	void run_one();
 	void set_actor(const actor_handle& hostActor);
+	void reset_actor();
 protected:
 	bool _waiting;
 	shared_strand _strand;
@@ -361,11 +372,14 @@ public:
 		auto& msgHandle_ = _msgHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long flow = actor_trace::msg_send(_hostActor->self_id());
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
+			actor_trace::msg_recv(hostActor_->self_id(), flow);
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				msgHandle_->push_msg(ref_ex<PT0, PT1, PT2, PT3>((PT0&)p0, (PT1&)p1, (PT2&)p2, (PT3&)p3));
+				msgHandle_->push_msg(ref_ex<PT0, PT1, PT2, PT3>((PT0&)p0, (PT1&)p1, (PT2&)p2, (PT3&)p3), sendCycle);
 			}
 		});
 	}
@@ -376,11 +390,14 @@ public:
 		auto& msgHandle_ = _msgHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long flow = actor_trace::msg_send(_hostActor->self_id());
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
+			actor_trace::msg_recv(hostActor_->self_id(), flow);
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				msgHandle_->push_msg(ref_ex<PT0, PT1, PT2>((PT0&)p0, (PT1&)p1, (PT2&)p2));
+				msgHandle_->push_msg(ref_ex<PT0, PT1, PT2>((PT0&)p0, (PT1&)p1, (PT2&)p2), sendCycle);
 			}
 		});
 	}
@@ -391,11 +408,14 @@ public:
 		auto& msgHandle_ = _msgHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long flow = actor_trace::msg_send(_hostActor->self_id());
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
+			actor_trace::msg_recv(hostActor_->self_id(), flow);
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				msgHandle_->push_msg(ref_ex<PT0, PT1>((PT0&)p0, (PT1&)p1));
+				msgHandle_->push_msg(ref_ex<PT0, PT1>((PT0&)p0, (PT1&)p1), sendCycle);
 			}
 		});
 	}
@@ -406,11 +426,14 @@ public:
 		auto& msgHandle_ = _msgHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long flow = actor_trace::msg_send(_hostActor->self_id());
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
+			actor_trace::msg_recv(hostActor_->self_id(), flow);
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				msgHandle_->push_msg(ref_ex<PT0>((PT0&)p0));
+				msgHandle_->push_msg(ref_ex<PT0>((PT0&)p0), sendCycle);
 			}
 		});
 	}
@@ -420,11 +443,14 @@ public:
 		auto& msgHandle_ = _msgHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long flow = actor_trace::msg_send(_hostActor->self_id());
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
+			actor_trace::msg_recv(hostActor_->self_id(), flow);
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				msgHandle_->push_msg();
+				msgHandle_->push_msg(sendCycle);
 			}
 		});
 	}
@@ -469,7 +495,7 @@ class actor_msg_handle: public actor_msg_handle_base
 	friend my_actor;
 public:
 	actor_msg_handle(size_t fixedSize = 16)
-		:_msgBuff(fixedSize), _dstRef(NULL) {}
+		:_msgBuff(fixedSize), _stampBuff(fixedSize), _dstRef(NULL) {}
 
 	~actor_msg_handle()
 	{
@@ -485,9 +511,15 @@ private:
 		return msg_notifer(this);
 	}
 
-	void push_msg(ref_type& msg)
+	void push_msg(ref_type& msg, unsigned long long sendCycle = 0)
 	{
 		assert(_strand->running_in_this_thread());
+		RUNTIME_METRIC(_mailboxPushed.add());
+		unsigned long long pushCycle = 0;
+		if (wake_latency::enabled())
+		{
+			pushCycle = wake_latency::on_push(_strand.get(), wake_latency::msg_mailbox, sendCycle);
+		}
 		if (_waiting)
 		{
 			_waiting = false;
@@ -495,19 +527,45 @@ private:
 			assert(_dstRef);
 			_dstRef->move_from(msg);
 			_dstRef = NULL;
+			if (pushCycle)
+			{
+				wake_latency::on_read(_strand.get(), wake_latency::msg_mailbox, pushCycle);
+			}
 			run_one();
 			return;
 		}
 		_msgBuff.push_back(std::move(msg_type(msg)));
+		if (wake_latency::enabled())
+		{//启用后不会再关闭，启用时每条消息一个时间戳，和 _msgBuff 一一对应
+			_stampBuff.push_back(pushCycle);
+		}
 	}
 
-	bool read_msg(ref_type& dst)
+	bool pop_msg(ref_type& dst)
 	{
 		assert(_strand->running_in_this_thread());
+		assert(!wake_latency::enabled() || _msgBuff.size() == _stampBuff.size());
 		if (!_msgBuff.empty())
 		{
 			_msgBuff.front().move_out(dst);
 			_msgBuff.pop_front();
+			if (wake_latency::enabled())
+			{
+				if (_stampBuff.front())
+				{
+					wake_latency::on_read(_strand.get(), wake_latency::msg_mailbox, _stampBuff.front());
+				}
+				_stampBuff.pop_front();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	bool read_msg(ref_type& dst)
+	{
+		if (pop_msg(dst))
+		{
 			return true;
 		}
 		_dstRef = &dst;
@@ -525,7 +583,8 @@ private:
 		_dstRef = NULL;
 		_waiting = false;
 		_msgBuff.clear();
-		_hostActor.reset();
+		_stampBuff.clear();
+		reset_actor();
 	}
 
 	size_t size()
@@ -533,9 +592,15 @@ private:
 		assert(_strand->running_in_this_thread());
 		return _msgBuff.size();
 	}
+
+	size_t depth()
+	{
+		return _msgBuff.size();
+	}
 private:
 	ref_type* _dstRef;
 	msg_queue<msg_type> _msgBuff;
+	msg_queue<unsigned long long> _stampBuff;///<每条消息进入邮箱的时间，只在启用 wake_latency 时使用
 };
 
 
@@ -547,6 +612,9 @@ class actor_msg_handle<void, void, void, void> : public actor_msg_handle_base
 	friend msg_notifer;
 	friend my_actor;
 public:
+	actor_msg_handle()
+		:_stampBuff(16) {}
+
 	~actor_msg_handle()
 	{
 		close();
@@ -561,24 +629,56 @@ private:
 		return msg_notifer(this);
 	}
 
-	void push_msg()
+	void push_msg(unsigned long long sendCycle = 0)
 	{
 		assert(_strand->running_in_this_thread());
+		RUNTIME_METRIC(_mailboxPushed.add());
+		unsigned long long pushCycle = 0;
+		if (wake_latency::enabled())
+		{
+			pushCycle = wake_latency::on_push(_strand.get(), wake_latency::msg_mailbox, sendCycle);
+		}
 		if (_waiting)
 		{
 			_waiting = false;
+			if (pushCycle)
+			{
+				wake_latency::on_read(_strand.get(), wake_latency::msg_mailbox, pushCycle);
+			}
 			run_one();
 			return;
 		}
 		_msgCount++;
+		if (wake_latency::enabled())
+		{
+			_stampBuff.push_back(pushCycle);
+		}
 	}
 
-	bool read_msg()
+	bool pop_msg()
 	{
 		assert(_strand->running_in_this_thread());
+		assert(!wake_latency::enabled() || _msgCount == _stampBuff.size());
 		if (_msgCount)
 		{
 			_msgCount--;
+			if (wake_latency::enabled())
+			{
+				if (_stampBuff.front())
+				{
+					wake_latency::on_read(_strand.get(), wake_latency::msg_mailbox, _stampBuff.front());
+				}
+				_stampBuff.pop_front();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	bool read_msg()
+	{
+		if (pop_msg())
+		{
 			return true;
 		}
 		_waiting = true;
@@ -594,7 +694,8 @@ private:
 		}
 		_msgCount = 0;
 		_waiting = false;
-		_hostActor.reset();
+		_stampBuff.clear();
+		reset_actor();
 	}
 
 	size_t size()
@@ -602,8 +703,14 @@ private:
 		assert(_strand->running_in_this_thread());
 		return _msgCount;
 	}
+
+	size_t depth()
+	{
+		return _msgCount;
+	}
 private:
 	size_t _msgCount;
+	msg_queue<unsigned long long> _stampBuff;///<只在启用 wake_latency 时使用
 };
 //////////////////////////////////////////////////////////////////////////
 
@@ -626,11 +733,12 @@ public:
 		auto& trigHandle_ = _trigHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				trigHandle_->push_msg(ref_ex<PT0, PT1, PT2, PT3>((PT0&)p0, (PT1&)p1, (PT2&)p2, (PT3&)p3));
+				trigHandle_->push_msg(ref_ex<PT0, PT1, PT2, PT3>((PT0&)p0, (PT1&)p1, (PT2&)p2, (PT3&)p3), sendCycle);
 			}
 		});
 	}
@@ -641,11 +749,12 @@ public:
 		auto& trigHandle_ = _trigHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				trigHandle_->push_msg(ref_ex<PT0, PT1, PT2>((PT0&)p0, (PT1&)p1, (PT2&)p2));
+				trigHandle_->push_msg(ref_ex<PT0, PT1, PT2>((PT0&)p0, (PT1&)p1, (PT2&)p2), sendCycle);
 			}
 		});
 	}
@@ -656,11 +765,12 @@ public:
 		auto& trigHandle_ = _trigHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				trigHandle_->push_msg(ref_ex<PT0, PT1>((PT0&)p0, (PT1&)p1));
+				trigHandle_->push_msg(ref_ex<PT0, PT1>((PT0&)p0, (PT1&)p1), sendCycle);
 			}
 		});
 	}
@@ -671,11 +781,12 @@ public:
 		auto& trigHandle_ = _trigHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				trigHandle_->push_msg(ref_ex<PT0>((PT0&)p0));
+				trigHandle_->push_msg(ref_ex<PT0>((PT0&)p0), sendCycle);
 			}
 		});
 	}
@@ -685,11 +796,12 @@ public:
 		auto& trigHandle_ = _trigHandle;
 		auto& hostActor_ = _hostActor;
 		auto& closed_ = _closed;
+		unsigned long long sendCycle = wake_latency::stamp();
 		_strand->post([=]()
 		{
 			if (!hostActor_->is_quited() && !(*closed_))
 			{
-				trigHandle_->push_msg();
+				trigHandle_->push_msg(sendCycle);
 			}
 		});
 	}
@@ -734,7 +846,7 @@ class actor_trig_handle : public actor_msg_handle_base
 	friend my_actor;
 public:
 	actor_trig_handle()
-		:_hasMsg(false), _dstRef(NULL) {}
+		:_hasMsg(false), _dstRef(NULL), _pushCycle(0) {}
 
 	~actor_trig_handle()
 	{
@@ -751,16 +863,21 @@ private:
 		return msg_notifer(this);
 	}
 
-	void push_msg(ref_type& msg)
+	void push_msg(ref_type& msg, unsigned long long sendCycle = 0)
 	{
 		assert(_strand->running_in_this_thread());
 		*_closed = true;
+		if (wake_latency::enabled())
+		{
+			_pushCycle = wake_latency::on_push(_strand.get(), wake_latency::trig_mailbox, sendCycle);
+		}
 		if (_waiting)
 		{
 			_waiting = false;
 			assert(_dstRef);
 			_dstRef->move_from(msg);
 			_dstRef = NULL;
+			read_stamp();
 			run_one();
 			return;
 		}
@@ -776,6 +893,7 @@ private:
 			_hasMsg = false;
 			((msg_type*)_msgBuff)->move_out(dst);
 			((msg_type*)_msgBuff)->~msg_type();
+			read_stamp();
 			return true;
 		}
 		_dstRef = &dst;
@@ -795,18 +913,34 @@ private:
 			_hasMsg = false;
 			((msg_type*)_msgBuff)->~msg_type();
 		}
+		_pushCycle = 0;
 		_dstRef = NULL;
 		_waiting = false;
-		_hostActor.reset();
+		reset_actor();
 	}
 public:
 	bool has()
 	{
 		return _hasMsg;
 	}
+
+	size_t depth()
+	{
+		return _hasMsg ? 1 : 0;
+	}
+private:
+	void read_stamp()
+	{
+		if (_pushCycle)
+		{
+			wake_latency::on_read(_strand.get(), wake_latency::trig_mailbox, _pushCycle);
+			_pushCycle = 0;
+		}
+	}
 private:
 	ref_type* _dstRef;
 	bool _hasMsg;
+	unsigned long long _pushCycle;
 	BYTE _msgBuff[sizeof(msg_type)];
 };
 
@@ -819,7 +953,7 @@ class actor_trig_handle<void, void, void, void> : public actor_msg_handle_base
 	friend my_actor;
 public:
 	actor_trig_handle()
-		:_hasMsg(false){}
+		:_hasMsg(false), _pushCycle(0) {}
 
 	~actor_trig_handle()
 	{
@@ -836,13 +970,18 @@ private:
 		return msg_notifer(this);
 	}
 
-	void push_msg()
+	void push_msg(unsigned long long sendCycle = 0)
 	{
 		assert(_strand->running_in_this_thread());
 		*_closed = true;
+		if (wake_latency::enabled())
+		{
+			_pushCycle = wake_latency::on_push(_strand.get(), wake_latency::trig_mailbox, sendCycle);
+		}
 		if (_waiting)
 		{
 			_waiting = false;
+			read_stamp();
 			run_one();
 			return;
 		}
@@ -855,6 +994,7 @@ private:
 		if (_hasMsg)
 		{
 			_hasMsg = false;
+			read_stamp();
 			return true;
 		}
 		_waiting = true;
@@ -869,16 +1009,32 @@ private:
 			assert(_strand->running_in_this_thread());
 		}
 		_hasMsg = false;
+		_pushCycle = 0;
 		_waiting = false;
-		_hostActor.reset();
+		reset_actor();
 	}
 public:
 	bool has()
 	{
 		return _hasMsg;
 	}
+
+	size_t depth()
+	{
+		return _hasMsg ? 1 : 0;
+	}
+private:
+	void read_stamp()
+	{
+		if (_pushCycle)
+		{
+			wake_latency::on_read(_strand.get(), wake_latency::trig_mailbox, _pushCycle);
+			_pushCycle = 0;
+		}
+	}
 private:
 	bool _hasMsg;
+	unsigned long long _pushCycle;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -962,7 +1118,7 @@ private:
 				}
 			}
 			else
-			{//pump_msgʱŽܵϢ
+			{//pump_msg超时结束后才接受到消息
 				assert(!_waiting);
 				_hasMsg = true;
 				new (_msgSpace)msg_type(std::move(msg));
@@ -1107,7 +1263,7 @@ class msg_pool : public msg_pool_base
 						}
 					}
 					else
-					{//ϴϢûȡȡʵмѾpostȥ
+					{//上次消息没取到，重新取，但实际中间已经post出去了
 						assert(!_thisPool->_waiting);
 						assert(pumpID + 1 == _thisPool->_sendCount);
 					}
@@ -1221,6 +1377,7 @@ private:
 
 	void push_msg(msg_type&& mt)
 	{
+		RUNTIME_METRIC(_mailboxPushed.add());
 		if (_strand->running_in_this_thread())
 		{
 			send_msg(std::move(mt), true);
@@ -1228,8 +1385,15 @@ private:
 		else
 		{
 			auto shared_this = _weakThis.lock();
+			unsigned long long flow = actor_trace::msg_send(0);
+			unsigned long long sendCycle = wake_latency::stamp();
 			_strand->post([=]()
 			{
+				actor_trace::msg_recv(0, flow);
+				if (sendCycle)
+				{
+					wake_latency::on_push(shared_this->_strand.get(), wake_latency::pump_mailbox, sendCycle);
+				}
 				shared_this->send_msg(std::move((msg_type&)mt), false);
 			});
 		}
@@ -1517,7 +1681,7 @@ private:
 
 //////////////////////////////////////////////////////////////////////////
 /*!
-@brief Actorɿ
+@brief 子Actor句柄，不可拷贝
 */
 class child_actor_handle 
 {
@@ -1526,7 +1690,7 @@ public:
 private:
 	friend my_actor;
 	/*!
-	@brief Actorchild_actor_handleʹ
+	@brief 子Actor句柄参数，child_actor_handle内使用
 	*/
 	struct child_actor_param
 	{
@@ -1537,8 +1701,8 @@ private:
 		child_actor_param& operator =(child_actor_param& s);
 		bool _isCopy;
 #endif
-		actor_handle _actor;///<Actor
-		list<actor_handle>::iterator _actorIt;///<ڸActorеĽڵ
+		actor_handle _actor;///<本Actor
+		list<actor_handle>::iterator _actorIt;///<保存在父Actor集合中的节点
 	};
 private:
 	child_actor_handle(child_actor_handle&);
@@ -1558,12 +1722,54 @@ public:
 	void operator delete(void* p);
 private:
 	DEBUG_OPERATION(list<std::function<void ()> >::iterator _qh);
-	bool _norQuit;///<Ƿ˳
-	bool _quited;///<ǷѾر
+	bool _norQuit;///<是否正常退出
+	bool _quited;///<检测是否已经关闭
 	child_actor_param _param;
 };
 //////////////////////////////////////////////////////////////////////////
 
+/*!
+@brief Actor树快照中的一个节点，由 my_actor::snapshot_tree 在该Actor所在strand中填写
+*/
+struct actor_snapshot
+{
+	enum wait_state
+	{
+		wait_none = 0,///<未开始、正在运行或已退出
+		wait_msg,///<等待消息/触发/消息泵
+		wait_timer,///<sleep中
+		wait_other///<其它让出(yield、等待子Actor、actor_mutex等)
+	};
+
+	long long _actorID;
+	long long _parentID;///<根Actor为0
+	bool _started;
+	bool _quited;
+	bool _suspended;
+	wait_state _waitFor;
+	size_t _stackSize;
+	size_t _stackFree;///<最近一次让出时的栈剩余空间
+	size_t _stackMinFree;///<所有让出点中最小的栈剩余空间
+	bool _hasTimer;
+	bool _timerArmed;///<定时器正在计时(sleep/delay_trig/timed_wait)
+	bool _timerSuspended;
+	std::vector<size_t> _mailboxDepths;///<本Actor各actor_msg_handle/actor_trig_handle中积压的消息数
+	size_t _pumpCount;///<消息泵数
+	std::vector<actor_snapshot> _children;
+};
+
+/*!
+@brief 一类Actor的最大栈使用量统计(字节)，见 my_actor::enable_stack_profile
+*/
+struct actor_stack_profile
+{
+	std::string _tag;///<入口函数类型名或 set_stack_tag 设置的标签
+	size_t _count;///<已退出的Actor数
+	size_t _p50;
+	size_t _p99;
+	size_t _maxUsed;
+};
+
 class my_actor
 {
 	struct suspend_resume_option 
@@ -1632,6 +1838,7 @@ class my_actor
 	};
 
 	struct timer_pck;
+	struct snapshot_walk;
 	class boost_actor_run;
 	friend boost_actor_run;
 	friend child_actor_handle;
@@ -1640,7 +1847,7 @@ class my_actor
 	friend trig_once_base;
 public:
 	/*!
-	@brief {}һΧǰActorǿ˳
+	@brief 在{}一定范围内锁定当前Actor不被强制退出
 	*/
 	class quit_guard
 	{
@@ -1662,17 +1869,17 @@ public:
 	};
 
 	/*!
-	@brief Actorǿ˳쳣
+	@brief Actor被强制退出的异常类型
 	*/
 	struct force_quit_exception { };
 
 	/*!
-	@brief ϢñϿ
+	@brief 消息泵被断开
 	*/
 	struct pump_disconnected_exception { };
 
 	/*!
-	@brief Actorں
+	@brief Actor入口函数体
 	*/
 	typedef std::function<void (my_actor*)> main_func;
 private:
@@ -1683,144 +1890,186 @@ public:
 	~my_actor();
 public:
 	/*!
-	@brief һActor
-	@param actorStrand Actorstrand
-	@param mainFunc Actorִ
-	@param stackSize ActorջСĬ64kֽڣ4kС4k1M
+	@brief 创建一个Actor
+	@param actorStrand Actor所依赖的strand
+	@param mainFunc Actor执行入口
+	@param stackSize Actor栈大小，默认64k字节，必须是4k的整数倍，最小4k，最大1M
 	*/
 	static actor_handle create(shared_strand actorStrand, const main_func& mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief ͬϣActorĻص֪ͨ
-	@param cb ActorɺĴfalseǿƽģtrue
+	@brief 同上，带完成Actor后的回调通知
+	@param cb Actor完成后的触发函数，false强制结束的，true正常结束
 	*/
 	static actor_handle create(shared_strand actorStrand, const main_func& mainFunc, 
 		const std::function<void (bool)>& cb, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief 첽һActorɹͨص֪ͨ
+	@brief 异步创建一个Actor，创建成功后通过回调函数通知
 	*/
 	static void async_create(shared_strand actorStrand, const main_func& mainFunc, 
 		const std::function<void (actor_handle)>& ch, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief ͬϣActorĻص֪ͨ
+	@brief 同上，带完成Actor后的回调通知
 	*/
 	static void async_create(shared_strand actorStrand, const main_func& mainFunc, 
 		const std::function<void (actor_handle)>& ch, const std::function<void (bool)>& cb, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief öջڴ
+	@brief 启用堆栈内存池
 	*/
 	static void enable_stack_pool();
 
 	/*!
-	@brief ôActorʱԶ춨ʱ
+	@brief 禁用创建Actor时自动构造定时器
 	*/
 	static void disable_auto_make_timer();
+
+	/*!
+	@brief 启用Actor运行时间统计(每次调度前后各读一次TSC)，在创建Actor之前调用
+	*/
+	static void enable_cpu_stat();
+
+	/*!
+	@brief 启用Actor树快照(登记根Actor、消息句柄和让出点栈深度)，在创建Actor之前调用
+	*/
+	static void enable_actor_tree();
+
+	/*!
+	@brief 异步获取所有存活Actor的树状快照，每个Actor在自己的strand中被访问，不暂停其它strand，
+	全部访问完后在最后完成的strand中回调 h(根Actor列表)，需先调用 enable_actor_tree
+	*/
+	static void snapshot_tree(const std::function<void (const std::shared_ptr<std::vector<actor_snapshot> >&)>& h);
+
+	/*!
+	@brief 启用栈使用量统计，创建时用固定值填满Actor栈，退出时扫描得到最大使用深度，
+	按入口函数类型(或 set_stack_tag 标签)汇总，在创建Actor之前调用
+	*/
+	static void enable_stack_profile();
+
+	/*!
+	@brief 获取各类Actor的栈使用量统计
+	*/
+	static std::vector<actor_stack_profile> stack_profile();
+
+	/*!
+	@brief 保存/加载各类Actor观测到的最大栈使用量(文本，每行 最大值<TAB>标签)，
+	加载后不启用统计也能按 AUTO_STACKSIZE 选择栈大小；标签默认是入口函数类型名，只对同一个可执行文件有效
+	*/
+	static bool save_stack_profile(const char* fileName);
+	static bool load_stack_profile(const char* fileName);
+
+	/*!
+	@brief 根据某类Actor观测到的最大栈使用量加上余量得到建议的栈大小(4k对齐，最大1M)，
+	q 小于1时改用 q 分位数(超过分位数的Actor会栈溢出，池中的栈没有保护页，只在明确知道分布时使用)；
+	没有统计数据(未启用 enable_stack_profile 也没有 load_stack_profile)时返回 DEFAULT_STACKSIZE；
+	create 传入 AUTO_STACKSIZE 时按入口函数类型自动选择
+	*/
+	static size_t auto_stack_size(const char* tag, double q = 1);
 public:
 	/*!
-	@brief һActorActorֹʱActorҲֹActorȫ˳󣬸ActorŽ
-	@param actorStrand Actorstrand
-	@param mainFunc Actorں
-	@param stackSize ActorջС4k1MB
-	@return Actorʹ child_actor_handle շֵ
+	@brief 创建一个子Actor，父Actor终止时，子Actor也终止（在子Actor都完全退出后，父Actor才结束）
+	@param actorStrand 子Actor依赖的strand
+	@param mainFunc 子Actor入口函数
+	@param stackSize Actor栈大小，4k的整数倍（最大1MB）
+	@return 子Actor句柄，使用 child_actor_handle 接收返回值
 	*/
 	child_actor_handle::child_actor_param create_child_actor(shared_strand actorStrand, const main_func& mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
 	child_actor_handle::child_actor_param create_child_actor(const main_func& mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief ʼActorֻܵһ
+	@brief 开始运行子Actor，只能调用一次
 	*/
 	void child_actor_run(child_actor_handle& actorHandle);
 	void child_actor_run(const list<child_actor_handle::ptr>& actorHandles);
 
 	/*!
-	@brief ǿֹһActor
+	@brief 强制终止一个子Actor
 	*/
 	__yield_interrupt bool child_actor_force_quit(child_actor_handle& actorHandle);
 	__yield_interrupt void child_actors_force_quit(const list<child_actor_handle::ptr>& actorHandles);
 
 	/*!
-	@brief ȴһActorɺ󷵻
-	@return ˳ķtruefalse
+	@brief 等待一个子Actor完成后返回
+	@return 正常退出的返回true，否则false
 	*/
 	__yield_interrupt bool child_actor_wait_quit(child_actor_handle& actorHandle);
 
 	/*!
-	@brief ȴһActorɺ󷵻
-	@return ˳ķtruefalse
+	@brief 等待一组子Actor完成后返回
+	@return 都正常退出的返回true，否则false
 	*/
 	__yield_interrupt void child_actors_wait_quit(const list<child_actor_handle::ptr>& actorHandles);
 
 	/*!
-	@brief Actor
+	@brief 挂起子Actor
 	*/
 	__yield_interrupt void child_actor_suspend(child_actor_handle& actorHandle);
 	
 	/*!
-	@brief һActor
+	@brief 挂起一组子Actor
 	*/
 	__yield_interrupt void child_actors_suspend(const list<child_actor_handle::ptr>& actorHandles);
 
 	/*!
-	@brief ָActor
+	@brief 恢复子Actor
 	*/
 	__yield_interrupt void child_actor_resume(child_actor_handle& actorHandle);
 	
 	/*!
-	@brief ָһActor
+	@brief 恢复一组子Actor
 	*/
 	__yield_interrupt void child_actors_resume(const list<child_actor_handle::ptr>& actorHandles);
 
 	/*!
-	@brief һActorActorִɺ󷵻
+	@brief 创建另一个Actor，Actor执行完成后返回
 	*/
 	__yield_interrupt bool run_child_actor_complete(shared_strand actorStrand, const main_func& h, size_t stackSize = DEFAULT_STACKSIZE);
 	__yield_interrupt bool run_child_actor_complete(const main_func& h, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief ʱȴActorڲֹʹòϵͳAPI Sleep()
-	@param ms ȴ0ʱʱActorִУֱ´α
+	@brief 延时等待，Actor内部禁止使用操作系统API Sleep()
+	@param ms 等待毫秒数，等于0时暂时放弃Actor执行，直到下次被调度器触发
 	*/
 	__yield_interrupt void sleep(int ms);
 
 	/*!
-	@brief disable_auto_make_timerʹ򿪵ǰActorʱ
+	@brief 调用disable_auto_make_timer后，使用这个打开当前Actor定时器
 	*/
 	void open_timer();
 
 	/*!
-	@brief رڲʱ
+	@brief 关闭内部定时器
 	*/
 	void close_timer();
 
 	/*!
-	@brief ȡActor
+	@brief 获取父Actor
 	*/
 	actor_handle parent_actor();
 
 	/*!
-	@brief ȡActor
+	@brief 获取子Actor
 	*/
 	const list<actor_handle>& child_actors();
 public:
 	typedef list<std::function<void ()> >::iterator quit_iterator;
 
 	/*!
-	@brief עһԴͷźǿ˳Actorʱ
+	@brief 注册一个资源释放函数，在强制退出Actor时调用
 	*/
 	quit_iterator regist_quit_handler(const std::function<void ()>& quitHandler);
 
 	/*!
-	@brief עԴͷź
+	@brief 注销资源释放函数
 	*/
 	void cancel_quit_handler(quit_iterator qh);
 public:
 	/*!
-	@brief ʹڲʱʱĳڴ֮ǰܶε
-	@param ms ʱ()
-	@param h 
+	@brief 使用内部定时器延时触发某个函数，在触发完成之前不能多次调用
+	@param ms 触发延时(毫秒)
+	@param h 触发函数
 	*/
 	template <typename H>
 	void delay_trig(int ms, const H& h)
@@ -1842,12 +2091,12 @@ public:
 	}
 
 	/*!
-	@brief ȡڲʱ
+	@brief 取消内部定时器触发
 	*/
 	void cancel_delay_trig();
 public:
 	/*!
-	@brief һ첽shared_strandִУɺ󷵻
+	@brief 发送一个异步函数到shared_strand中执行，完成后返回
 	*/
 	template <typename H>
 	__yield_interrupt void send(shared_strand exeStrand, const H& h)
@@ -1901,7 +2150,7 @@ public:
 	}
 
 	/*!
-	@brief һ첽첽صɺ󷵻
+	@brief 调用一个异步函数，异步回调完成后返回
 	*/
 	template <typename H>
 	__yield_interrupt void trig(const H& h)
@@ -1983,7 +2232,7 @@ private:
 	}
 public:
 	/*!
-	@brief һϢ֪ͨ
+	@brief 创建一个消息通知函数
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	actor_msg_notifer<T0, T1, T2, T3> make_msg_notifer(actor_msg_handle<T0, T1, T2, T3>& amh)
@@ -2012,12 +2261,12 @@ public:
 	actor_msg_notifer<> make_msg_notifer(actor_msg_handle<>& amh);
 
 	/*!
-	@brief رϢ֪ͨ
+	@brief 关闭消息通知句柄
 	*/
 	void close_msg_notifer(actor_msg_handle_base& amh);
 public:
 	/*!
-	@brief ʹڲʱʱĳ֮ǰùmake_trig_notifer
+	@brief 使用内部定时器延时触发某个句柄，之前必须调用过make_trig_notifer
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	void delay_trig(int ms, actor_trig_handle<T0, T1, T2, T3>& ath, const T0& p0, const T1& p1, const T2& p2, const T3& p3)
@@ -2098,6 +2347,7 @@ private:
 					run_one();
 				});
 			}
+			_yieldReason = yield_for_msg;
 			push_yield();
 			if (!timeout)
 			{
@@ -2115,9 +2365,9 @@ private:
 	}
 public:
 	/*!
-	@brief ϢȡϢ
-	@param tm ʱʱ
-	@return ʱɷfalseɹȡϢtrue
+	@brief 从消息句柄中提取消息
+	@param tm 超时时间
+	@return 超时完成返回false，成功提取消息返回true
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt bool timed_wait_msg(int tm, actor_msg_handle<T0, T1, T2, T3>& amh, T0& r0, T1& r1, T2& r2, T3& r3)
@@ -2158,7 +2408,7 @@ public:
 	__yield_interrupt bool timed_wait_msg(int tm, actor_msg_handle<>& amh);
 
 	/*!
-	@brief ϢȡϢ
+	@brief 从消息句柄中提取消息
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt void wait_msg(actor_msg_handle<T0, T1, T2, T3>& amh, T0& r0, T1& r1, T2& r2, T3& r3)
@@ -2193,9 +2443,59 @@ public:
 	}
 
 	__yield_interrupt void wait_msg(actor_msg_handle<>& amh);
+private:
+	template <typename AMH, typename DST>
+	bool _try_wait_msg(AMH& amh, DST& dstRef)
+	{
+		assert(amh._hostActor && amh._hostActor->self_id() == self_id());
+		assert(!amh._waiting);
+		return amh.pop_msg(dstRef);
+	}
+public:
+	/*!
+	@brief 尝试从消息句柄中提取消息，没有消息时立即返回，不切换Actor
+	@return 成功提取消息返回true
+	*/
+	template <typename T0, typename T1, typename T2, typename T3>
+	bool try_wait_msg(actor_msg_handle<T0, T1, T2, T3>& amh, T0& r0, T1& r1, T2& r2, T3& r3)
+	{
+		assert_enter();
+		assert(amh._closed && !(*amh._closed));
+		ref_ex<T0, T1, T2, T3> dstRef(r0, r1, r2, r3);
+		return _try_wait_msg(amh, dstRef);
+	}
+
+	template <typename T0, typename T1, typename T2>
+	bool try_wait_msg(actor_msg_handle<T0, T1, T2>& amh, T0& r0, T1& r1, T2& r2)
+	{
+		assert_enter();
+		assert(amh._closed && !(*amh._closed));
+		ref_ex<T0, T1, T2> dstRef(r0, r1, r2);
+		return _try_wait_msg(amh, dstRef);
+	}
+
+	template <typename T0, typename T1>
+	bool try_wait_msg(actor_msg_handle<T0, T1>& amh, T0& r0, T1& r1)
+	{
+		assert_enter();
+		assert(amh._closed && !(*amh._closed));
+		ref_ex<T0, T1> dstRef(r0, r1);
+		return _try_wait_msg(amh, dstRef);
+	}
+
+	template <typename T0>
+	bool try_wait_msg(actor_msg_handle<T0>& amh, T0& r0)
+	{
+		assert_enter();
+		assert(amh._closed && !(*amh._closed));
+		ref_ex<T0> dstRef(r0);
+		return _try_wait_msg(amh, dstRef);
+	}
+
+	bool try_wait_msg(actor_msg_handle<>& amh);
 public:
 	/*!
-	@brief һϢֻһδЧ
+	@brief 创建一个消息触发函数，只有一次触发有效
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	actor_trig_notifer<T0, T1, T2, T3> make_trig_notifer(actor_trig_handle<T0, T1, T2, T3>& ath)
@@ -2224,14 +2524,14 @@ public:
 	actor_trig_notifer<> make_trig_notifer(actor_trig_handle<>& ath);
 
 	/*!
-	@brief رϢ
+	@brief 关闭消息触发句柄
 	*/
 	void close_trig_notifer(actor_msg_handle_base& ath);
 public:
 	/*!
-	@brief ӴȡϢ
-	@param tm ʱʱ
-	@return ʱɷfalseɹȡϢtrue
+	@brief 从触发句柄中提取消息
+	@param tm 超时时间
+	@return 超时完成返回false，成功提取消息返回true
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt bool timed_wait_trig(int tm, actor_trig_handle<T0, T1, T2, T3>& ath, T0& r0, T1& r1, T2& r2, T3& r3)
@@ -2272,7 +2572,7 @@ public:
 	__yield_interrupt bool timed_wait_trig(int tm, actor_trig_handle<>& ath);
 
 	/*!
-	@brief ӴȡϢ
+	@brief 从触发句柄中提取消息
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt void wait_trig(actor_trig_handle<T0, T1, T2, T3>& ath, T0& r0, T1& r1, T2& r2, T3& r3)
@@ -2425,7 +2725,7 @@ private:
 	}
 private:
 	/*!
-	@brief ѱActorϢɻActor
+	@brief 把本Actor内消息由伙伴Actor代理处理
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt void msg_agent_to(const actor_handle& childActor)
@@ -2489,8 +2789,8 @@ public:
 
 public:
 	/*!
-	@brief ϢָһضActorȥ
-	@return شϢActor
+	@brief 把消息指定到一个特定Actor函数体去处理
+	@return 返回处理该消息的子Actor句柄
 	*/
 	template <typename T0, typename T1, typename T2, typename T3, typename Handler>
 	child_actor_handle::child_actor_param msg_agent_to_actor(bool autoRun, const Handler& agentActor, size_t stackSize = DEFAULT_STACKSIZE)
@@ -2532,7 +2832,7 @@ public:
 	}
 public:
 	/*!
-	@brief ϿϢ
+	@brief 断开伙伴代理该消息
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt void msg_agent_off()
@@ -2576,11 +2876,11 @@ public:
 	__yield_interrupt void msg_agent_off();
 public:
 	/*!
-	@brief Ϣ֪ͨһActorActorActorûиActor
-	@param makeNew false ڷ֮ǰ򴴽µ֪ͨtrue ǿƴµ֪֮ͨǰĽʧЧҶϿbuddyActorĹ
-	@param fixedSize Ϣڴس
-	@warning  makeNew = false ҸýڵΪĴʧ
-	@return Ϣ֪ͨ
+	@brief 连接消息通知到一个伙伴Actor，该Actor必须是子Actor或没有父Actor
+	@param makeNew false 如果存在返回之前，否则创建新的通知；true 强制创建新的通知，之前的将失效，且断开与buddyActor的关联
+	@param fixedSize 消息队列内存池长度
+	@warning 如果 makeNew = false 且该节点为父的代理，将创建失败
+	@return 消息通知函数
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt post_actor_msg<T0, T1, T2, T3> connect_msg_notifer_to(const actor_handle& buddyActor, bool makeNew = false, size_t fixedSize = 16)
@@ -2711,11 +3011,11 @@ public:
 	__yield_interrupt post_actor_msg<> connect_msg_notifer_to(child_actor_handle& childActor, bool makeNew = false);
 
 	/*!
-	@brief Ϣ֪ͨԼActor
-	@param makeNew false ڷ֮ǰ򴴽µ֪ͨtrue ǿƴµ֪֮ͨǰĽʧЧҶϿbuddyActorĹ
-	@param fixedSize Ϣڴس
-	@warning ýڵΪĴôʧ
-	@return Ϣ֪ͨ
+	@brief 连接消息通知到自己的Actor
+	@param makeNew false 如果存在返回之前，否则创建新的通知；true 强制创建新的通知，之前的将失效，且断开与buddyActor的关联
+	@param fixedSize 消息队列内存池长度
+	@warning 如果该节点为父的代理，那么将创建失败
+	@return 消息通知函数
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt post_actor_msg<T0, T1, T2, T3> connect_msg_notifer_to_self(bool makeNew = false, size_t fixedSize = 16)
@@ -2765,9 +3065,9 @@ public:
 	__yield_interrupt post_actor_msg<> connect_msg_notifer_to_self(bool makeNew = false);
 
 	/*!
-	@brief һϢ֪ͨڸActorios޹߳ʹãڸActor notify_run() ֮ǰ
-	@param fixedSize Ϣڴس
-	@return Ϣ֪ͨ
+	@brief 创建一个消息通知函数，在该Actor所依赖的ios无关线程中使用，且在该Actor调用 notify_run() 之前
+	@param fixedSize 消息队列内存池长度
+	@return 消息通知函数
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	post_actor_msg<T0, T1, T2, T3> connect_msg_notifer(size_t fixedSize = 16)
@@ -2810,8 +3110,8 @@ public:
 	//////////////////////////////////////////////////////////////////////////
 
 	/*!
-	@brief ϢõϢ
-	@return Ϣþ
+	@brief 连接消息泵到消息池
+	@return 返回消息泵句柄
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	typename msg_pump<T0, T1, T2, T3>::handle connect_msg_pump()
@@ -2898,6 +3198,7 @@ private:
 					}
 				});
 			}
+			_yieldReason = yield_for_msg;
 			push_yield();
 			if (!timeOut)
 			{
@@ -2923,10 +3224,10 @@ private:
 public:
 
 	/*!
-	@brief ϢȡϢ
-	@param tm ʱʱ
-	@param checkDis Ƿ񱻶ϿӣǾ׳ pump_disconnected_exception 쳣
-	@return ʱɷfalseɹȡϢtrue
+	@brief 从消息泵中提取消息
+	@param tm 超时时间
+	@param checkDis 检测是否被断开连接，是就抛出 pump_disconnected_exception 异常
+	@return 超时完成返回false，成功取到消息返回true
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt bool timed_pump_msg(int tm, const typename msg_pump<T0, T1, T2, T3>::handle& pump, T0& r0, T1& r1, T2& r2, T3& r3, bool checkDis = false)
@@ -2963,7 +3264,7 @@ public:
 	__yield_interrupt bool timed_pump_msg(int tm, const msg_pump<>::handle& pump, bool checkDis = false);
 
 	/*!
-	@brief ϢȡϢ
+	@brief 从消息泵中提取消息
 	*/
 	template <typename T0, typename T1, typename T2, typename T3>
 	__yield_interrupt void pump_msg(const typename msg_pump<T0, T1, T2, T3>::handle& pump, T0& r0, T1& r1, T2& r2, T3& r3, bool checkDis = false)
@@ -3000,135 +3301,145 @@ public:
 	__yield_interrupt void pump_msg(const msg_pump<>::handle& pump, bool checkDis = false);
 public:
 	/*!
-	@brief ԵǰµActorջǷȫ
+	@brief 测试当前下的Actor栈是否安全
 	*/
 	void check_stack();
 
 	/*!
-	@brief ȡǰActorʣలȫջռ
+	@brief 获取当前Actor剩余安全栈空间
 	*/
 	size_t stack_free_space();
 
 	/*!
-	@brief ȡǰActor
+	@brief 设置本Actor栈使用量统计的分类标签，tag 必须一直有效(如字符串常量)
+	*/
+	void set_stack_tag(const char* tag);
+
+	/*!
+	@brief 获取当前Actor调度器
 	*/
 	shared_strand self_strand();
 
 	/*!
-	@brief رָ
+	@brief 返回本对象的智能指针
 	*/
 	actor_handle shared_from_this();
 
 	/*!
-	@brief ȡǰActorID
+	@brief 获取当前ActorID号
 	*/
 	long long self_id();
 
 	/*!
-	@brief ȡActorл
+	@brief 获取Actor切换计数
 	*/
 	size_t yield_count();
 
 	/*!
-	@brief Actorл
+	@brief Actor切换计数清零
 	*/
 	void reset_yield();
 
 	/*!
-	@brief ʼнõActor
+	@brief 获取本Actor运行时间统计，在本Actor所在strand中调用，需启用 enable_cpu_stat
+	*/
+	actor_cpu_stat cpu_stat();
+
+	/*!
+	@brief 开始运行建立好的Actor
 	*/
 	void notify_run();
 
 	/*!
-	@brief ǿ˳ActorãпܻԴй©
+	@brief 强制退出该Actor，不可滥用，有可能会造成资源泄漏
 	*/
 	void notify_quit();
 
 	/*!
-	@brief ǿ˳Actorɺص
+	@brief 强制退出该Actor，完成后回调
 	*/
 	void notify_quit(const std::function<void (bool)>& h);
 
 	/*!
-	@brief ActorǷѾʼ
+	@brief Actor是否已经开始运行
 	*/
 	bool is_started();
 
 	/*!
-	@brief ActorǷѾ˳
+	@brief Actor是否已经退出
 	*/
 	bool is_quited();
 
 	/*!
-	@brief ǰActorʱǿ˳
+	@brief 锁定当前Actor，暂时不让强制退出
 	*/
 	void lock_quit();
 
 	/*!
-	@brief ˳
+	@brief 解除退出锁定
 	*/
 	void unlock_quit();
 
 	/*!
-	@brief ͣActor
+	@brief 暂停Actor
 	*/
 	void notify_suspend();
 	void notify_suspend(const std::function<void ()>& h);
 
 	/*!
-	@brief ָͣActor
+	@brief 恢复已暂停Actor
 	*/
 	void notify_resume();
 	void notify_resume(const std::function<void ()>& h);
 
 	/*!
-	@brief л/ǹ״̬
+	@brief 切换挂起/非挂起状态
 	*/
 	void switch_pause_play();
 	void switch_pause_play(const std::function<void (bool isPaused)>& h);
 
 	/*!
-	@brief ȴActor˳Actorios޹߳ʹ
+	@brief 等待Actor退出，在Actor所依赖的ios无关线程中使用
 	*/
 	bool outside_wait_quit();
 
 	/*!
-	@brief һActorص
+	@brief 添加一个Actor结束回调
 	*/
 	void append_quit_callback(const std::function<void (bool)>& h);
 
 	/*!
-	@brief һActor
+	@brief 启动一堆Actor
 	*/
 	void actors_start_run(const list<actor_handle>& anotherActors);
 
 	/*!
-	@brief ǿ˳һActorҵȴ
+	@brief 强制退出另一个Actor，并且等待完成
 	*/
 	__yield_interrupt bool actor_force_quit(const actor_handle& anotherActor);
 	__yield_interrupt void actors_force_quit(const list<actor_handle>& anotherActors);
 
 	/*!
-	@brief ȴһActor󷵻
+	@brief 等待另一个Actor结束后返回
 	*/
 	__yield_interrupt bool actor_wait_quit(const actor_handle& anotherActor);
 	__yield_interrupt void actors_wait_quit(const list<actor_handle>& anotherActors);
 
 	/*!
-	@brief һActorȴActorúŷ
+	@brief 挂起另一个Actor，等待其所有子Actor都调用后才返回
 	*/
 	__yield_interrupt void actor_suspend(const actor_handle& anotherActor);
 	__yield_interrupt void actors_suspend(const list<actor_handle>& anotherActors);
 
 	/*!
-	@brief ָһActorȴActorúŷ
+	@brief 恢复另一个Actor，等待其所有子Actor都调用后才返回
 	*/
 	__yield_interrupt void actor_resume(const actor_handle& anotherActor);
 	__yield_interrupt void actors_resume(const list<actor_handle>& anotherActors);
 
 	/*!
-	@brief һActorй/ָ״̬л
-	@return ѹ𷵻truefalse
+	@brief 对另一个Actor进行挂起/恢复状态切换
+	@return 都已挂起返回true，否则false
 	*/
 	__yield_interrupt bool actor_switch(const actor_handle& anotherActor);
 	__yield_interrupt bool actors_switch(const list<actor_handle>& anotherActors);
@@ -3149,36 +3460,59 @@ private:
 	void run_one();
 	void pull_yield();
 	void push_yield();
+
+	enum yield_reason
+	{
+		yield_other = 0,
+		yield_for_msg,
+		yield_for_timer
+	};
+	void snapshot_visit(actor_snapshot* node, long long parentID, const std::shared_ptr<snapshot_walk>& walk);
+	void stack_profile_record();
+
+	/*!
+	@brief 创建Actor但不登记为根Actor，create_child_actor 使用
+	*/
+	static actor_handle create_(shared_strand actorStrand, const main_func& mainFunc, const std::function<void (bool)>& cb, size_t stackSize);
 	void force_quit_cb_handler();
 	void exit_callback();
 	void child_suspend_cb_handler();
 	void child_resume_cb_handler();
 private:
-	void* _actorPull;///<Actorжϵָ
-	void* _actorPush;///<Actorжϵ
-	void* _stackTop;///<Actorջ
+	void* _actorPull;///<Actor中断点恢复
+	void* _actorPush;///<Actor中断点
+	void* _stackTop;///<Actor栈顶
 	long long _selfID;///<ActorID
-	size_t _stackSize;///<ActorջС
-	shared_strand _strand;///<Actor
-	DEBUG_OPERATION(bool _inActor);///<ǰActorڲִб
-	bool _started;///<Ѿʼеı
-	bool _quited;///<Ѿ׼˳
-	bool _suspended;///<Actor
-	bool _hasNotify;///<ǰActorⲿ׼Actor
-	bool _isForce;///<Ƿǿ˳ıǣɹforce_quit
-	bool _notifyQuited;///<ǰActorյ˳Ϣ
-	size_t _lockQuit;///<ǰActorǰյ˳Ϣʱˣȵ˳
-	size_t _yieldCount;//yield
-	size_t _childOverCount;///<Actor˳ʱ
-	size_t _childSuspendResumeCount;///<Actor/ָ
-	std::weak_ptr<my_actor> _parentActor;///<Actor
-	main_func _mainFunc;///<Actor
-	list<suspend_resume_option> _suspendResumeQueue;///</ָ
-	list<actor_handle> _childActorList;///<Actor
-	list<std::function<void (bool)> > _exitCallback;///<ActorĻصǿ˳false˳true
-	list<std::function<void ()> > _quitHandlerList;///<Actor˳ʱǿƵõĺעִ
-	msg_pool_status _msgPoolStatus;//Ϣб
-	timer_pck* _timer;///<ṩʱ
+	size_t _stackSize;///<Actor栈大小
+	const char* _stackTag;///<栈使用量统计分类
+	bool _isRootActor;///<已登记到根Actor表(启用 enable_actor_tree 时不是子Actor)
+	shared_strand _strand;///<Actor调度器
+	DEBUG_OPERATION(bool _inActor);///<当前正在Actor内部执行标记
+	bool _started;///<已经开始运行的标记
+	bool _quited;///<已经准备退出标记
+	bool _suspended;///<Actor挂起标记
+	bool _hasNotify;///<当前Actor挂起，有外部触发准备进入Actor标记
+	bool _isForce;///<是否是强制退出的标记，成功调用了force_quit
+	bool _notifyQuited;///<当前Actor被锁定后，收到退出消息
+	size_t _lockQuit;///<锁定当前Actor，如果当前接收到退出消息，暂时不退，等到解锁后退出
+	size_t _yieldCount;//yield计数
+	unsigned char _yieldReason;///<最近一次让出的原因，用于统计等待时间
+	unsigned long long _yieldCycle;///<最近一次让出时的TSC
+	actor_cpu_stat _cpuStat;
+	size_t _yieldStackFree;///<最近一次让出时的栈剩余空间，启用 enable_actor_tree 时记录
+	size_t _minStackFree;
+	size_t _childOverCount;///<子Actor退出时计数
+	size_t _childSuspendResumeCount;///<子Actor挂起/恢复计数
+	std::weak_ptr<my_actor> _parentActor;///<父Actor
+	main_func _mainFunc;///<Actor入口
+	list<suspend_resume_option> _suspendResumeQueue;///<挂起/恢复操作队列
+	list<actor_handle> _childActorList;///<子Actor集合
+	list<actor_msg_handle_base*> _msgHandleList;///<绑定到本Actor的消息句柄，启用 enable_actor_tree 时登记
+	boost::mutex _msgHandleMutex;///<make_msg_notifer 可能在Actor的strand外调用，_msgHandleList 加锁访问
+	list<std::function<void (bool)> > _exitCallback;///<Actor结束后的回调函数，强制退出返回false，正常退出返回true
+	list<std::function<void ()> > _quitHandlerList;///<Actor退出时强制调用的函数，后注册的先执行
+	msg_pool_status _msgPoolStatus;//消息池列表
+	timer_pck* _timer;///<提供延时功能
 	std::weak_ptr<my_actor> _weakThis;
 };
 
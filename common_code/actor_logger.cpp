@@ -0,0 +1,346 @@
+#include "actor_logger.h"
+#include "scattered.h"
+#include <algorithm>
+#include <stdio.h>
+#include <ctype.h>
+
+/*!
+@brief 单线程写、日志Actor读的环形队列
+*/
+struct actor_logger::log_ring
+{
+	log_ring(size_t size)
+		: _records(size), _writePos(0), _readPos(0), _thread(GetCurrentThreadId()) {}
+
+	std::vector<log_record> _records;
+	boost::atomic<size_t> _writePos;
+	boost::atomic<size_t> _readPos;
+	DWORD _thread;
+};
+
+//本线程最近使用的日志(按实例编号，不按地址，日志释放后同一地址上的新日志不会误用旧队列)及其队列，多个日志交替使用时退回到查表
+static __declspec(thread) unsigned long long _tlsLoggerID = 0;
+static __declspec(thread) void* _tlsRing = NULL;
+static boost::atomic<unsigned long long> _loggerIDCount(0);
+
+actor_logger::actor_logger()
+: _ios(1)
+{
+	_closed = false;
+	_writers = 0;
+	_id = ++_loggerIDCount;
+	_file = NULL;
+	_flushBytes = 0;
+	_flushMs = 0;
+	_ringSize = 0;
+	_dropped = 0;
+}
+
+actor_logger::~actor_logger()
+{
+	close();
+	for (size_t i = 0; i < _rings.size(); i++)
+	{
+		delete _rings[i];
+	}
+	if (_file)
+	{
+		CloseHandle((HANDLE)_file);
+	}
+}
+
+std::shared_ptr<actor_logger> actor_logger::create(const char* fileName, size_t flushBytes, int flushMs, size_t ringSize)
+{
+	assert(flushBytes && flushMs > 0 && ringSize >= 2);
+	HANDLE file = CreateFileA(fileName, FILE_APPEND_DATA, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return std::shared_ptr<actor_logger>();
+	}
+	std::shared_ptr<actor_logger> res(new actor_logger);
+	res->_file = file;
+	res->_flushBytes = flushBytes;
+	res->_flushMs = flushMs;
+	res->_ringSize = ringSize;
+	//写文件会阻塞线程，日志Actor运行在自己的调度器中
+	res->_ios.run(1);
+	actor_logger* logger = res.get();
+	res->_actor = my_actor::create(boost_strand::create(res->_ios), [logger](my_actor* self){logger->logActor(self); });
+	res->_wakeup = res->_actor->make_msg_notifer(res->_wakeupOut);
+	res->_actor->notify_run();
+	return res;
+}
+
+actor_logger::log_ring* actor_logger::this_ring()
+{
+	if (_id == _tlsLoggerID)
+	{
+		return (log_ring*)_tlsRing;
+	}
+	DWORD tid = GetCurrentThreadId();
+	log_ring* ring = NULL;
+	{
+		boost::lock_guard<boost::mutex> lg(_ringMutex);
+		for (size_t i = 0; i < _rings.size(); i++)
+		{
+			if (tid == _rings[i]->_thread)
+			{
+				ring = _rings[i];
+				break;
+			}
+		}
+		if (!ring)
+		{
+			ring = new log_ring(_ringSize);
+			_rings.push_back(ring);
+		}
+	}
+	_tlsLoggerID = _id;
+	_tlsRing = ring;
+	return ring;
+}
+
+log_record* actor_logger::alloc_record(const char* fmt, size_t argc)
+{
+	assert(argc <= LOG_MAX_ARGS);
+	//先登记写入者再检查关闭标记，close看到写入者为0后才能释放唤醒函数和队列
+	_writers++;
+	if (_closed)
+	{
+		_writers--;
+		return NULL;
+	}
+	log_ring* ring = this_ring();
+	size_t w = ring->_writePos.load(boost::memory_order_relaxed);
+	if (w - ring->_readPos.load(boost::memory_order_acquire) >= ring->_records.size())
+	{
+		_dropped++;
+		_writers--;
+		return NULL;
+	}
+	log_record* rec = &ring->_records[w % ring->_records.size()];
+	rec->_tick = get_tick_us();
+	rec->_fmt = fmt;
+	rec->_argc = argc;
+	return rec;
+}
+
+void actor_logger::commit_record()
+{
+	log_ring* ring = (log_ring*)_tlsRing;
+	size_t w = ring->_writePos.load(boost::memory_order_relaxed) + 1;
+	ring->_writePos.store(w, boost::memory_order_release);
+	//队列到一半时提前唤醒日志Actor，其它情况等定时批量取出
+	if (w - ring->_readPos.load(boost::memory_order_relaxed) == ring->_records.size() / 2)
+	{
+		_wakeup(false);
+	}
+	_writers--;
+}
+
+void actor_logger::log(const char* fmt)
+{
+	if (alloc_record(fmt, 0))
+	{
+		commit_record();
+	}
+}
+
+size_t actor_logger::dropped()
+{
+	return _dropped;
+}
+
+void actor_logger::close()
+{
+	if (!_closed.exchange(true))
+	{
+		assert(!_ios.runningInThisIos());
+		//等其它线程中正在写的记录提交完
+		while (_writers)
+		{
+			Sleep(0);
+		}
+		_wakeup(true);
+		_actor->outside_wait_quit();
+		_ios.stop();
+		clear_function(_wakeup);
+		_actor.reset();
+	}
+}
+
+size_t actor_logger::drain(std::vector<log_record>& batch)
+{
+	std::vector<log_ring*> rings;
+	{
+		boost::lock_guard<boost::mutex> lg(_ringMutex);
+		rings = _rings;
+	}
+	size_t ct = 0;
+	for (size_t i = 0; i < rings.size(); i++)
+	{
+		log_ring* ring = rings[i];
+		size_t r = ring->_readPos.load(boost::memory_order_relaxed);
+		size_t w = ring->_writePos.load(boost::memory_order_acquire);
+		for (; r != w; r++, ct++)
+		{
+			batch.push_back(ring->_records[r % ring->_records.size()]);
+		}
+		ring->_readPos.store(r, boost::memory_order_release);
+	}
+	return ct;
+}
+
+void actor_logger::format(const log_record& rec, std::vector<char>& out)
+{
+	char buff[512];
+	int n = _snprintf_s(buff, sizeof(buff), _TRUNCATE, "[%lld.%06lld] ", rec._tick / 1000000, rec._tick % 1000000);
+	out.insert(out.end(), buff, buff + n);
+	const char* p = rec._fmt;
+	size_t argi = 0;
+	while (*p)
+	{
+		const char* pc = strchr(p, '%');
+		if (!pc)
+		{
+			out.insert(out.end(), p, p + strlen(p));
+			break;
+		}
+		out.insert(out.end(), p, pc);
+		if ('%' == pc[1])
+		{
+			out.push_back('%');
+			p = pc + 2;
+			continue;
+		}
+		//截取一个格式说明符，用对应类型的参数单独格式化
+		const char* pe = pc + 1;
+		while (*pe && !strchr("diouxXeEfgGcsp", *pe))
+		{
+			pe++;
+		}
+		if (!*pe || argi >= rec._argc)
+		{
+			out.insert(out.end(), pc, pe + (*pe ? 1 : 0));
+			p = pe + (*pe ? 1 : 0);
+			continue;
+		}
+		//只保留标志、宽度和精度，长度修饰按参数类型重新生成
+		char spec[32];
+		size_t specLength = 0;
+		spec[specLength++] = '%';
+		for (const char* ps = pc + 1; ps != pe && specLength < sizeof(spec) - 4; ps++)
+		{
+			if ('I' == *ps)
+			{
+				while (ps + 1 != pe && isdigit((unsigned char)ps[1]))
+				{
+					ps++;
+				}
+			}
+			else if (strchr("-+ #0123456789.", *ps))
+			{
+				spec[specLength++] = *ps;
+			}
+		}
+		const log_arg& arg = rec._args[argi++];
+		buff[0] = 0;
+		n = -1;
+		switch (arg._type)
+		{
+		case log_arg::int_type:
+		case log_arg::uint_type:
+			if ('c' == *pe)
+			{
+				spec[specLength++] = 'c';
+				spec[specLength] = 0;
+				n = _snprintf_s(buff, sizeof(buff), _TRUNCATE, spec, (int)arg._i);
+			}
+			else if (strchr("diouxX", *pe))
+			{
+				spec[specLength++] = 'l';
+				spec[specLength++] = 'l';
+				spec[specLength++] = *pe;
+				spec[specLength] = 0;
+				n = _snprintf_s(buff, sizeof(buff), _TRUNCATE, spec, arg._i);
+			}
+			break;
+		case log_arg::double_type:
+			if (strchr("eEfgG", *pe))
+			{
+				spec[specLength++] = *pe;
+				spec[specLength] = 0;
+				n = _snprintf_s(buff, sizeof(buff), _TRUNCATE, spec, arg._d);
+			}
+			break;
+		case log_arg::str_type:
+			if ('s' == *pe)
+			{
+				spec[specLength++] = 's';
+				spec[specLength] = 0;
+				n = _snprintf_s(buff, sizeof(buff), _TRUNCATE, spec, arg._s ? arg._s : "(null)");
+			}
+			break;
+		case log_arg::ptr_type:
+			if ('p' == *pe)
+			{
+				spec[specLength++] = 'p';
+				spec[specLength] = 0;
+				n = _snprintf_s(buff, sizeof(buff), _TRUNCATE, spec, arg._p);
+			}
+			break;
+		}
+		if (n < 0)
+		{//参数类型与格式不符，或输出被截断
+			n = (int)strlen(buff);
+			if (!n)
+			{
+				buff[0] = '?';
+				n = 1;
+			}
+		}
+		out.insert(out.end(), buff, buff + n);
+		p = pe + 1;
+	}
+	out.push_back('\r');
+	out.push_back('\n');
+}
+
+void actor_logger::logActor(my_actor* self)
+{
+	std::vector<log_record> batch;
+	std::vector<char> out;
+	long long lastFlush = get_tick_ms();
+	bool exit = false;
+	while (!exit)
+	{
+		bool closing = false;
+		if (self->timed_wait_msg(_flushMs, _wakeupOut, closing) && closing)
+		{
+			exit = true;
+		}
+		batch.clear();
+		if (drain(batch))
+		{
+			//各线程队列内有序，合并后按时间排序
+			std::stable_sort(batch.begin(), batch.end(), [](const log_record& a, const log_record& b)->bool
+			{
+				return a._tick < b._tick;
+			});
+			for (size_t i = 0; i < batch.size(); i++)
+			{
+				format(batch[i], out);
+			}
+		}
+		long long now = get_tick_ms();
+		if (!out.empty() && (exit || out.size() >= _flushBytes || now - lastFlush >= _flushMs))
+		{
+			//整批日志一次写出
+			DWORD written = 0;
+			WriteFile((HANDLE)_file, &out[0], (DWORD)out.size(), &written, NULL);
+			out.clear();
+			lastFlush = now;
+		}
+	}
+	self->close_msg_notifer(_wakeupOut);
+}
@@ -0,0 +1,198 @@
+#ifndef __ACTOR_LOGGER_H
+#define __ACTOR_LOGGER_H
+
+#include "actor_framework.h"
+#include "ios_proxy.h"
+#include <boost/atomic/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <vector>
+
+#define LOG_MAX_ARGS	6
+
+/*!
+@brief 日志参数，记录时只保存值，格式化延后到日志Actor中；字符串参数只保存指针，必须在日志写出前一直有效(如字面常量)
+*/
+struct log_arg
+{
+	enum arg_type
+	{
+		int_type,
+		uint_type,
+		double_type,
+		str_type,
+		ptr_type
+	};
+
+	log_arg() {}
+	log_arg(int v): _type(int_type) {_i = v;}
+	log_arg(long v): _type(int_type) {_i = v;}
+	log_arg(long long v): _type(int_type) {_i = v;}
+	log_arg(unsigned v): _type(uint_type) {_i = (long long)v;}
+	log_arg(unsigned long v): _type(uint_type) {_i = (long long)v;}
+	log_arg(unsigned long long v): _type(uint_type) {_i = (long long)v;}
+	log_arg(double v): _type(double_type) {_d = v;}
+	log_arg(const char* v): _type(str_type) {_s = v;}
+	log_arg(const void* v): _type(ptr_type) {_p = v;}
+
+	arg_type _type;
+	union
+	{
+		long long _i;
+		double _d;
+		const char* _s;
+		const void* _p;
+	};
+};
+
+/*!
+@brief 定长日志记录
+*/
+struct log_record
+{
+	long long _tick;
+	const char* _fmt;
+	size_t _argc;
+	log_arg _args[LOG_MAX_ARGS];
+};
+
+/*!
+@brief 异步批量日志，各线程把定长记录写入本线程的无锁环形队列(写满时丢弃)，
+独立调度器上的日志Actor批量取出、格式化，累计到 flushBytes 或每隔 flushMs 一次写入文件
+*/
+class actor_logger
+{
+	struct log_ring;
+private:
+	actor_logger();
+public:
+	~actor_logger();
+	/*!
+	@brief 创建日志
+	@param fileName 日志文件，追加写入
+	@param flushBytes 缓存超过这个字节数时写文件
+	@param flushMs 最长写文件间隔
+	@param ringSize 每个线程环形队列的记录数
+	@return 打开文件失败返回空
+	*/
+	static std::shared_ptr<actor_logger> create(const char* fileName, size_t flushBytes = 64 kB, int flushMs = 100, size_t ringSize = 4096);
+public:
+	/*!
+	@brief 写日志，不阻塞，参数最多LOG_MAX_ARGS个，格式与printf相同
+	*/
+	void log(const char* fmt);
+
+	template <typename A0>
+	void log(const char* fmt, const A0& a0)
+	{
+		log_record* rec = alloc_record(fmt, 1);
+		if (rec)
+		{
+			rec->_args[0] = log_arg(a0);
+			commit_record();
+		}
+	}
+
+	template <typename A0, typename A1>
+	void log(const char* fmt, const A0& a0, const A1& a1)
+	{
+		log_record* rec = alloc_record(fmt, 2);
+		if (rec)
+		{
+			rec->_args[0] = log_arg(a0);
+			rec->_args[1] = log_arg(a1);
+			commit_record();
+		}
+	}
+
+	template <typename A0, typename A1, typename A2>
+	void log(const char* fmt, const A0& a0, const A1& a1, const A2& a2)
+	{
+		log_record* rec = alloc_record(fmt, 3);
+		if (rec)
+		{
+			rec->_args[0] = log_arg(a0);
+			rec->_args[1] = log_arg(a1);
+			rec->_args[2] = log_arg(a2);
+			commit_record();
+		}
+	}
+
+	template <typename A0, typename A1, typename A2, typename A3>
+	void log(const char* fmt, const A0& a0, const A1& a1, const A2& a2, const A3& a3)
+	{
+		log_record* rec = alloc_record(fmt, 4);
+		if (rec)
+		{
+			rec->_args[0] = log_arg(a0);
+			rec->_args[1] = log_arg(a1);
+			rec->_args[2] = log_arg(a2);
+			rec->_args[3] = log_arg(a3);
+			commit_record();
+		}
+	}
+
+	template <typename A0, typename A1, typename A2, typename A3, typename A4>
+	void log(const char* fmt, const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+	{
+		log_record* rec = alloc_record(fmt, 5);
+		if (rec)
+		{
+			rec->_args[0] = log_arg(a0);
+			rec->_args[1] = log_arg(a1);
+			rec->_args[2] = log_arg(a2);
+			rec->_args[3] = log_arg(a3);
+			rec->_args[4] = log_arg(a4);
+			commit_record();
+		}
+	}
+
+	template <typename A0, typename A1, typename A2, typename A3, typename A4, typename A5>
+	void log(const char* fmt, const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+	{
+		log_record* rec = alloc_record(fmt, 6);
+		if (rec)
+		{
+			rec->_args[0] = log_arg(a0);
+			rec->_args[1] = log_arg(a1);
+			rec->_args[2] = log_arg(a2);
+			rec->_args[3] = log_arg(a3);
+			rec->_args[4] = log_arg(a4);
+			rec->_args[5] = log_arg(a5);
+			commit_record();
+		}
+	}
+
+	/*!
+	@brief 写出剩余日志并关闭，等其它线程正在写的记录提交后返回，不能在日志调度器中调用
+	*/
+	void close();
+
+	/*!
+	@brief 因队列满丢弃的记录数
+	*/
+	size_t dropped();
+private:
+	log_ring* this_ring();
+	log_record* alloc_record(const char* fmt, size_t argc);
+	void commit_record();
+	void logActor(my_actor* self);
+	size_t drain(std::vector<log_record>& batch);
+	void format(const log_record& rec, std::vector<char>& out);
+private:
+	boost::atomic<bool> _closed;
+	boost::atomic<int> _writers;///<正在 alloc_record/commit_record 中的线程数
+	unsigned long long _id;
+	void* _file;
+	size_t _flushBytes;
+	int _flushMs;
+	size_t _ringSize;
+	boost::atomic<size_t> _dropped;
+	boost::mutex _ringMutex;
+	std::vector<log_ring*> _rings;
+	std::function<void (bool)> _wakeup;
+	actor_msg_handle<bool> _wakeupOut;
+	actor_handle _actor;
+	ios_proxy _ios;
+};
+
+#endif
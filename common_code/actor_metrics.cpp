@@ -0,0 +1,369 @@
+#include "actor_metrics.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <assert.h>
+#include <stdio.h>
+#include <list>
+#include <Windows.h>
+#include <intrin.h>
+
+enum metric_type
+{
+	metric_type_counter,
+	metric_type_gauge,
+	metric_type_histogram,
+	metric_type_gauge_fn
+};
+
+struct metric_entry
+{
+	std::string _name;
+	std::string _help;
+	metric_type _type;
+	void* _metric;
+	std::function<long long ()> _fn;
+};
+
+static boost::atomic<int> _metricShardCount(0);
+static __declspec(thread) int _metricShard = -1;
+static boost::mutex _metricMutex;
+static std::list<metric_entry> _metricEntries;
+
+bool runtime_metrics::_enabled = false;
+metric_gauge runtime_metrics::_iosThreads;
+metric_counter runtime_metrics::_strandPosts;
+metric_counter runtime_metrics::_iosStalls;
+metric_counter runtime_metrics::_strandCreated;
+metric_gauge runtime_metrics::_strandAlive;
+metric_counter runtime_metrics::_actorCreated;
+metric_counter runtime_metrics::_actorExited;
+metric_gauge runtime_metrics::_actorAlive;
+metric_counter runtime_metrics::_mailboxPushed;
+metric_gauge runtime_metrics::_timerAlive;
+metric_gauge runtime_metrics::_socketAlive;
+metric_counter runtime_metrics::_socketConnects;
+metric_counter runtime_metrics::_socketReadBytes;
+metric_counter runtime_metrics::_socketWriteBytes;
+
+static int metric_shard()
+{
+	int i = _metricShard;
+	if (i < 0)
+	{
+		i = _metricShard = _metricShardCount++ % METRIC_SHARDS;
+	}
+	return i;
+}
+
+void runtime_metrics::enable()
+{
+	_enabled = true;
+}
+
+metric_counter::metric_counter()
+{
+	for (int i = 0; i < METRIC_SHARDS; i++)
+	{
+		_shards[i]._value = 0;
+	}
+}
+
+void metric_counter::add(long long n)
+{
+	_shards[metric_shard()]._value.fetch_add(n, boost::memory_order_relaxed);
+}
+
+long long metric_counter::value()
+{
+	long long v = 0;
+	for (int i = 0; i < METRIC_SHARDS; i++)
+	{
+		v += _shards[i]._value.load(boost::memory_order_relaxed);
+	}
+	return v;
+}
+//////////////////////////////////////////////////////////////////////////
+
+metric_gauge::metric_gauge()
+{
+	for (int i = 0; i < METRIC_SHARDS; i++)
+	{
+		_shards[i]._value = 0;
+	}
+}
+
+void metric_gauge::set(long long v)
+{
+	for (int i = 1; i < METRIC_SHARDS; i++)
+	{
+		_shards[i]._value.store(0, boost::memory_order_relaxed);
+	}
+	_shards[0]._value.store(v, boost::memory_order_relaxed);
+}
+
+void metric_gauge::add(long long n)
+{
+	_shards[metric_shard()]._value.fetch_add(n, boost::memory_order_relaxed);
+}
+
+void metric_gauge::sub(long long n)
+{
+	_shards[metric_shard()]._value.fetch_sub(n, boost::memory_order_relaxed);
+}
+
+long long metric_gauge::value()
+{
+	long long v = 0;
+	for (int i = 0; i < METRIC_SHARDS; i++)
+	{
+		v += _shards[i]._value.load(boost::memory_order_relaxed);
+	}
+	return v;
+}
+//////////////////////////////////////////////////////////////////////////
+
+metric_histogram::metric_histogram()
+{
+	for (int i = 0; i < METRIC_BUCKETS; i++)
+	{
+		_buckets[i] = 0;
+	}
+	_count = 0;
+	_sum = 0;
+}
+
+size_t metric_histogram::bucket_index(unsigned long long v)
+{
+	if (v < METRIC_SUB_BUCKETS)
+	{
+		return (size_t)v;
+	}
+	unsigned long msb = 0;
+#ifdef _WIN64
+	_BitScanReverse64(&msb, v);
+#else
+	if (v >> 32)
+	{
+		_BitScanReverse(&msb, (unsigned long)(v >> 32));
+		msb += 32;
+	}
+	else
+	{
+		_BitScanReverse(&msb, (unsigned long)v);
+	}
+#endif
+	//msb >= 4，取最高位之后的4位作为子桶
+	return METRIC_SUB_BUCKETS + (msb - 4) * METRIC_SUB_BUCKETS + (size_t)((v >> (msb - 4)) & (METRIC_SUB_BUCKETS - 1));
+}
+
+unsigned long long metric_histogram::bucket_upper(size_t i)
+{
+	assert(i < METRIC_BUCKETS);
+	if (i < METRIC_SUB_BUCKETS)
+	{
+		return i;
+	}
+	size_t shift = (i - METRIC_SUB_BUCKETS) / METRIC_SUB_BUCKETS;
+	size_t sub = (i - METRIC_SUB_BUCKETS) % METRIC_SUB_BUCKETS;
+	unsigned long long lower = (unsigned long long)(METRIC_SUB_BUCKETS + sub) << shift;
+	return lower + ((unsigned long long)1 << shift) - 1;
+}
+
+void metric_histogram::record(unsigned long long v)
+{
+	_buckets[bucket_index(v)].fetch_add(1, boost::memory_order_relaxed);
+	_count.fetch_add(1, boost::memory_order_relaxed);
+	_sum.fetch_add(v, boost::memory_order_relaxed);
+}
+
+unsigned long long metric_histogram::count()
+{
+	return _count.load(boost::memory_order_relaxed);
+}
+
+unsigned long long metric_histogram::sum()
+{
+	return _sum.load(boost::memory_order_relaxed);
+}
+
+unsigned long long metric_histogram::percentile(double q)
+{
+	unsigned long long total = 0;
+	for (int i = 0; i < METRIC_BUCKETS; i++)
+	{
+		total += _buckets[i].load(boost::memory_order_relaxed);
+	}
+	if (!total)
+	{
+		return 0;
+	}
+	unsigned long long rank = (unsigned long long)(q * (double)(total - 1)) + 1;
+	unsigned long long ct = 0;
+	for (int i = 0; i < METRIC_BUCKETS; i++)
+	{
+		ct += _buckets[i].load(boost::memory_order_relaxed);
+		if (ct >= rank)
+		{
+			return bucket_upper(i);
+		}
+	}
+	return bucket_upper(METRIC_BUCKETS - 1);
+}
+//////////////////////////////////////////////////////////////////////////
+
+static void* find_metric(const char* name, metric_type type)
+{
+	for (auto it = _metricEntries.begin(); it != _metricEntries.end(); it++)
+	{
+		if (it->_name == name)
+		{
+			assert(it->_type == type);
+			return it->_type == type ? it->_metric : NULL;
+		}
+	}
+	return NULL;
+}
+
+static void add_metric(const char* name, const char* help, metric_type type, void* metric)
+{
+	metric_entry entry;
+	entry._name = name;
+	entry._help = help;
+	entry._type = type;
+	entry._metric = metric;
+	_metricEntries.push_back(entry);
+}
+
+static void regist_runtime_metrics()
+{
+	if (!_metricEntries.empty())
+	{
+		return;
+	}
+	add_metric("actor_ios_threads", "ios scheduler threads", metric_type_gauge, &runtime_metrics::_iosThreads);
+	add_metric("actor_strand_posts_total", "handlers posted to strands", metric_type_counter, &runtime_metrics::_strandPosts);
+	add_metric("actor_ios_stalls_total", "handlers or actor slices flagged by the ios watchdog", metric_type_counter, &runtime_metrics::_iosStalls);
+	add_metric("actor_strand_created_total", "strands created", metric_type_counter, &runtime_metrics::_strandCreated);
+	add_metric("actor_strand_alive", "strands alive", metric_type_gauge, &runtime_metrics::_strandAlive);
+	add_metric("actor_created_total", "actors created", metric_type_counter, &runtime_metrics::_actorCreated);
+	add_metric("actor_exited_total", "actors exited", metric_type_counter, &runtime_metrics::_actorExited);
+	add_metric("actor_alive", "actor objects alive", metric_type_gauge, &runtime_metrics::_actorAlive);
+	add_metric("actor_mailbox_pushed_total", "messages pushed to actor mailboxes", metric_type_counter, &runtime_metrics::_mailboxPushed);
+	add_metric("actor_timer_alive", "timers taken from the timer pool", metric_type_gauge, &runtime_metrics::_timerAlive);
+	add_metric("actor_socket_alive", "socket_io objects alive", metric_type_gauge, &runtime_metrics::_socketAlive);
+	add_metric("actor_socket_connects_total", "outgoing connects started", metric_type_counter, &runtime_metrics::_socketConnects);
+	add_metric("actor_socket_read_bytes_total", "bytes read by socket_io", metric_type_counter, &runtime_metrics::_socketReadBytes);
+	add_metric("actor_socket_write_bytes_total", "bytes written by socket_io", metric_type_counter, &runtime_metrics::_socketWriteBytes);
+}
+
+metric_counter* metrics_registry::counter(const char* name, const char* help)
+{
+	boost::lock_guard<boost::mutex> lg(_metricMutex);
+	regist_runtime_metrics();
+	metric_counter* res = (metric_counter*)find_metric(name, metric_type_counter);
+	if (!res)
+	{
+		res = new metric_counter;
+		add_metric(name, help, metric_type_counter, res);
+	}
+	return res;
+}
+
+metric_gauge* metrics_registry::gauge(const char* name, const char* help)
+{
+	boost::lock_guard<boost::mutex> lg(_metricMutex);
+	regist_runtime_metrics();
+	metric_gauge* res = (metric_gauge*)find_metric(name, metric_type_gauge);
+	if (!res)
+	{
+		res = new metric_gauge;
+		add_metric(name, help, metric_type_gauge, res);
+	}
+	return res;
+}
+
+metric_histogram* metrics_registry::histogram(const char* name, const char* help)
+{
+	boost::lock_guard<boost::mutex> lg(_metricMutex);
+	regist_runtime_metrics();
+	metric_histogram* res = (metric_histogram*)find_metric(name, metric_type_histogram);
+	if (!res)
+	{
+		res = new metric_histogram;
+		add_metric(name, help, metric_type_histogram, res);
+	}
+	return res;
+}
+
+void metrics_registry::gauge_fn(const char* name, const char* help, const std::function<long long ()>& fn)
+{
+	boost::lock_guard<boost::mutex> lg(_metricMutex);
+	regist_runtime_metrics();
+	for (auto it = _metricEntries.begin(); it != _metricEntries.end(); it++)
+	{
+		if (it->_name == name)
+		{
+			assert(metric_type_gauge_fn == it->_type);
+			it->_fn = fn;
+			return;
+		}
+	}
+	add_metric(name, help, metric_type_gauge_fn, NULL);
+	_metricEntries.back()._fn = fn;
+}
+
+std::string metrics_registry::export_text()
+{
+	boost::lock_guard<boost::mutex> lg(_metricMutex);
+	regist_runtime_metrics();
+	std::string res;
+	char buf[256];
+	for (auto it = _metricEntries.begin(); it != _metricEntries.end(); it++)
+	{
+		const char* name = it->_name.c_str();
+		const char* typeName = metric_type_counter == it->_type ? "counter" : (metric_type_histogram == it->_type ? "histogram" : "gauge");
+		res += "# HELP ";
+		res += it->_name;
+		res += " ";
+		res += it->_help;
+		res += "\n# TYPE ";
+		res += it->_name;
+		res += " ";
+		res += typeName;
+		res += "\n";
+		switch (it->_type)
+		{
+		case metric_type_counter:
+			sprintf_s(buf, "%s %lld\n", name, ((metric_counter*)it->_metric)->value());
+			res += buf;
+			break;
+		case metric_type_gauge:
+			sprintf_s(buf, "%s %lld\n", name, ((metric_gauge*)it->_metric)->value());
+			res += buf;
+			break;
+		case metric_type_gauge_fn:
+			sprintf_s(buf, "%s %lld\n", name, it->_fn ? it->_fn() : 0);
+			res += buf;
+			break;
+		case metric_type_histogram:
+			{//只在2的幂边界上输出累计桶，控制输出行数
+				metric_histogram* hist = (metric_histogram*)it->_metric;
+				unsigned long long total = hist->count();
+				unsigned long long ct = 0;
+				for (size_t i = 0; i < METRIC_BUCKETS && ct < total; i++)
+				{
+					ct += hist->_buckets[i].load(boost::memory_order_relaxed);
+					if (i >= METRIC_SUB_BUCKETS - 1 && METRIC_SUB_BUCKETS - 1 == i % METRIC_SUB_BUCKETS)
+					{
+						sprintf_s(buf, "%s_bucket{le=\"%llu\"} %llu\n", name, metric_histogram::bucket_upper(i), ct);
+						res += buf;
+					}
+				}
+				sprintf_s(buf, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %llu\n%s_count %llu\n", name, total, name, hist->sum(), name, total);
+				res += buf;
+			}
+			break;
+		}
+	}
+	return res;
+}
@@ -0,0 +1,144 @@
+#ifndef __ACTOR_METRICS_H
+#define __ACTOR_METRICS_H
+
+#include <boost/atomic/atomic.hpp>
+#include <functional>
+#include <string>
+
+#define METRIC_SHARDS		16
+#define METRIC_SUB_BUCKETS	16
+#define METRIC_BUCKETS		(METRIC_SUB_BUCKETS + 60 * METRIC_SUB_BUCKETS)
+
+/*!
+@brief 计数器，按线程分片累加，各线程写各自的缓存行，读取时合计
+*/
+class metric_counter
+{
+	struct __declspec(align(64)) shard
+	{
+		boost::atomic<long long> _value;
+	};
+public:
+	metric_counter();
+private:
+	metric_counter(const metric_counter&);
+	metric_counter& operator =(const metric_counter&);
+public:
+	void add(long long n = 1);
+	long long value();
+private:
+	shard _shards[METRIC_SHARDS];
+};
+
+/*!
+@brief 瞬时值，和计数器一样按线程分片，读取时合计；set 只用于单线程更新的值
+*/
+class metric_gauge
+{
+	struct __declspec(align(64)) shard
+	{
+		boost::atomic<long long> _value;
+	};
+public:
+	metric_gauge();
+private:
+	metric_gauge(const metric_gauge&);
+	metric_gauge& operator =(const metric_gauge&);
+public:
+	void set(long long v);
+	void add(long long n = 1);
+	void sub(long long n = 1);
+	long long value();
+private:
+	shard _shards[METRIC_SHARDS];
+};
+
+/*!
+@brief 对数-线性分桶直方图(HDR风格)，每个2的幂区间再等分16个桶，相对误差不超过1/16，
+记录只有两次原子加
+*/
+class metric_histogram
+{
+	friend class metrics_registry;
+public:
+	metric_histogram();
+private:
+	metric_histogram(const metric_histogram&);
+	metric_histogram& operator =(const metric_histogram&);
+public:
+	void record(unsigned long long v);
+	unsigned long long count();
+	unsigned long long sum();
+
+	/*!
+	@brief 分位数(0~1)，返回所在桶的上界
+	*/
+	unsigned long long percentile(double q);
+
+	/*!
+	@brief 第 i 个桶的上界(含)
+	*/
+	static unsigned long long bucket_upper(size_t i);
+	static size_t bucket_index(unsigned long long v);
+private:
+	boost::atomic<unsigned long long> _buckets[METRIC_BUCKETS];
+	boost::atomic<unsigned long long> _count;
+	boost::atomic<unsigned long long> _sum;
+};
+
+/*!
+@brief 全局指标注册表，同名指标只创建一次，指标对象在进程内一直有效；
+注册和导出加锁，指标更新无锁，不要在全局对象构造过程中注册
+*/
+class metrics_registry
+{
+public:
+	static metric_counter* counter(const char* name, const char* help);
+	static metric_gauge* gauge(const char* name, const char* help);
+	static metric_histogram* histogram(const char* name, const char* help);
+
+	/*!
+	@brief 注册一个导出时才取值的瞬时值，用于已有的内部计数
+	*/
+	static void gauge_fn(const char* name, const char* help, const std::function<long long ()>& fn);
+
+	/*!
+	@brief 导出所有指标，Prometheus文本格式
+	*/
+	static std::string export_text();
+};
+
+//更新内置指标，未启用 runtime_metrics::enable 时只有一次判断
+#define RUNTIME_METRIC(__op__)	do {if (runtime_metrics::_enabled) {runtime_metrics::__op__;}} while (0)
+
+/*!
+@brief 运行时内置指标，由框架各模块通过 RUNTIME_METRIC 更新；默认关闭(导出为0)，
+在创建ios_proxy、strand、Actor之前调用 enable 启用
+*/
+struct runtime_metrics
+{
+	static void enable();
+
+	static bool enabled()
+	{
+		return _enabled;
+	}
+
+	static bool _enabled;
+	static metric_gauge _iosThreads;///<ios调度线程数
+	static metric_counter _strandPosts;///<投递到strand的handler数
+	static metric_counter _iosStalls;///<看门狗发现的长时间运行handler数
+	static metric_counter _strandCreated;
+	static metric_gauge _strandAlive;
+	static metric_counter _actorCreated;
+	static metric_counter _actorExited;
+	static metric_gauge _actorAlive;
+	static metric_counter _mailboxPushed;///<投递到actor_msg_handle/msg_pool的消息数
+	static metric_gauge _timerAlive;///<定时器池中使用中的定时器
+	static metric_gauge _socketAlive;
+	static metric_counter _socketConnects;
+	static metric_counter _socketReadBytes;
+	static metric_counter _socketWriteBytes;
+};
+
+#endif
@@ -7,7 +7,7 @@ class _actor_mutex;
 class my_actor;
 
 /*!
-@brief Actorɵݹ飬ʹǰ my_actor::quit_guard ϣֹ lock ǿ˳޷ unlock
+@brief Actor锁，可递归，使用前与 my_actor::quit_guard 配合，防止 lock 后被强制退出造成无法 unlock
 */
 class actor_mutex
 {
@@ -16,24 +16,24 @@ public:
 	~actor_mutex();
 public:
 	/*!
-	@brief ԴActorУȴֱȣ unlock Уɵݹ
-	@warning Actorǿ˳п lock ޷ unlock
+	@brief 锁定资源，如果被别的Actor持有，等待，直到被调度，用 unlock 解除持有；可递归调用
+	@warning 所在Actor如果被强制退出，有可能造成 lock 后，无法 unlock
 	*/
 	void lock(my_actor* self) const;
 
 	/*!
-	@brief ԵǰǷѾռãѾĳУԼв㣩ͷûУԼУ unlock 
-	@return ѾActor falseɹзtrue
+	@brief 测试当前是否已经被占用，如果已经被别的持有（被自己持有不算）就放弃；如果没持有，则自己持有，用 unlock 解除持有
+	@return 已经被别的Actor返回 false，成功持有返回true
 	*/
 	bool try_lock(my_actor* self) const;
 
 	/*!
-	@brief ǰActorУݹ lock ΣҪ unlock 
+	@brief 解除当前Actor对其持有，递归 lock 几次，就需要 unlock 几次
 	*/
 	void unlock(my_actor* self) const;
 
 	/*!
-	@brief mutexʹǰȷǰûһActormutex
+	@brief 重置mutex，使用前确保当前没有一个Actor依赖该mutex了
 	*/
 	void reset_mutex(my_actor* self);
 private:
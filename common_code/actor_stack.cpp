@@ -1,12 +1,13 @@
 #include "actor_stack.h"
 #include "shared_data.h"
 #include "scattered.h"
+#include "actor_metrics.h"
 
-//ջС()
+//堆栈清理最小周期(秒)
 #define STACK_MIN_CLEAR_CYCLE		30
 
 #ifdef _DEBUG
-//ԶջͷźǷֱ޸
+//测试堆栈释放后是否又被修改了
 #define CHECK_STACK(__st__)\
 {\
 	size_t* p = (size_t*)((char*)(__st__)._stack.sp - (__st__)._stack.size); \
@@ -73,6 +74,14 @@ actor_stack_pool::~actor_stack_pool()
 void actor_stack_pool::enable()
 {
 	_actorStackPool = std::shared_ptr<actor_stack_pool>(new actor_stack_pool());
+	metrics_registry::gauge_fn("actor_stack_pool_count", "stacks allocated by the stack pool", []()->long long
+	{
+		return _actorStackPool ? (long long)_actorStackPool->_stackCount : 0;
+	});
+	metrics_registry::gauge_fn("actor_stack_pool_bytes", "bytes of stacks allocated by the stack pool", []()->long long
+	{
+		return _actorStackPool ? (long long)_actorStackPool->_stackTotalSize : 0;
+	});
 }
 
 bool actor_stack_pool::isEnable()
@@ -111,7 +120,7 @@ stack_pck actor_stack_pool::getStack( size_t size )
 	{
 		return r;
 	}
-	throw std::shared_ptr<string>(new string("Actorջڴ治"));
+	throw std::shared_ptr<string>(new string("Actor栈内存不足"));
 }
 
 void actor_stack_pool::recovery( stack_pck& stack )
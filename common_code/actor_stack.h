@@ -17,7 +17,7 @@ struct stack_pck
 };
 
 /*!
-@brief Actorջ
+@brief Actor栈池
 */
 class actor_stack_pool
 {
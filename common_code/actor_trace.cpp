@@ -0,0 +1,171 @@
+#include "actor_trace.h"
+#include "scattered.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <algorithm>
+#include <vector>
+#include <list>
+#include <stdio.h>
+#include <Windows.h>
+#include <intrin.h>
+
+/*!
+@brief 单个线程的事件环，只有本线程写，导出时其它线程读
+*/
+struct trace_ring
+{
+	trace_event* _events;
+	size_t _mask;
+	boost::atomic<size_t> _head;
+	unsigned _tid;
+};
+
+bool actor_trace::_enabled = false;
+static boost::atomic<bool> _tracePaused(false);
+static size_t _traceRingSize = 0;
+static boost::atomic<unsigned long long> _traceFlowCount(0);
+static boost::mutex _traceMutex;
+static std::list<trace_ring*> _traceRings;
+static __declspec(thread) trace_ring* _tlsTraceRing = NULL;
+
+void actor_trace::enable(size_t eventsPerThread)
+{
+	assert(eventsPerThread);
+	size_t size = 1;
+	while (size < eventsPerThread)
+	{
+		size <<= 1;
+	}
+	_traceRingSize = size;
+	calibrate_cycle();
+	_enabled = true;
+}
+
+void actor_trace::pause(bool paused)
+{
+	_tracePaused.store(paused, boost::memory_order_relaxed);
+}
+
+static trace_ring* new_ring()
+{
+	trace_ring* ring = new trace_ring;
+	ring->_events = new trace_event[_traceRingSize];
+	ring->_mask = _traceRingSize - 1;
+	ring->_head = 0;
+	ring->_tid = GetCurrentThreadId();
+	boost::lock_guard<boost::mutex> lg(_traceMutex);
+	_traceRings.push_back(ring);
+	return ring;
+}
+
+void actor_trace::record(trace_event_type type, long long actorID, unsigned long long flow)
+{
+	if (!_enabled || _tracePaused.load(boost::memory_order_relaxed))
+	{
+		return;
+	}
+	trace_ring* ring = _tlsTraceRing;
+	if (!ring)
+	{
+		ring = _tlsTraceRing = new_ring();
+	}
+	size_t head = ring->_head.load(boost::memory_order_relaxed);
+	trace_event& ev = ring->_events[head & ring->_mask];
+	ev._cycle = __rdtsc();
+	ev._actorID = actorID;
+	ev._flow = flow;
+	ev._type = type;
+	ring->_head.store(head + 1, boost::memory_order_release);
+}
+
+unsigned long long actor_trace::record_send(long long actorID)
+{
+	unsigned long long flow = ++_traceFlowCount;
+	record(trace_msg_send, actorID, flow);
+	return flow;
+}
+
+bool actor_trace::dump_json(const char* fileName)
+{
+	FILE* file = NULL;
+	if (fopen_s(&file, fileName, "wb") || !file)
+	{
+		return false;
+	}
+	std::vector<std::pair<unsigned, std::vector<trace_event> > > snapshots;
+	{
+		boost::lock_guard<boost::mutex> lg(_traceMutex);
+		for (auto it = _traceRings.begin(); it != _traceRings.end(); it++)
+		{
+			trace_ring* ring = *it;
+			size_t head = ring->_head.load(boost::memory_order_acquire);
+			size_t count = head > ring->_mask ? ring->_mask + 1 : head;
+			snapshots.push_back(std::make_pair(ring->_tid, std::vector<trace_event>()));
+			std::vector<trace_event>& events = snapshots.back().second;
+			events.reserve(count);
+			for (size_t i = head - count; i != head; i++)
+			{
+				events.push_back(ring->_events[i & ring->_mask]);
+			}
+			//复制期间写线程可能已经绕回，序号不大于 newHead-容量 的槽位已被(或正在被)改写，丢掉
+			boost::atomic_thread_fence(boost::memory_order_acquire);
+			size_t newHead = ring->_head.load(boost::memory_order_relaxed);
+			if (newHead - (head - count) >= ring->_mask + 1)
+			{
+				size_t torn = newHead - (head - count) - ring->_mask;
+				events.erase(events.begin(), events.begin() + std::min(torn, events.size()));
+			}
+		}
+	}
+	unsigned long long baseCycle = (unsigned long long)-1;
+	for (size_t i = 0; i < snapshots.size(); i++)
+	{
+		if (!snapshots[i].second.empty())
+		{
+			baseCycle = std::min(baseCycle, snapshots[i].second.front()._cycle);
+		}
+	}
+	unsigned pid = GetCurrentProcessId();
+	bool first = true;
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	for (size_t i = 0; i < snapshots.size(); i++)
+	{
+		unsigned tid = snapshots[i].first;
+		fprintf(file, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", first ? "" : ",", pid, tid, tid);
+		first = false;
+		std::vector<trace_event>& events = snapshots[i].second;
+		for (size_t j = 0; j < events.size(); j++)
+		{
+			const trace_event& ev = events[j];
+			double ts = cycle_to_us(ev._cycle - baseCycle);
+			switch (ev._type)
+			{
+			case trace_actor_resume:
+				fprintf(file, ",\n{\"ph\":\"B\",\"cat\":\"actor\",\"name\":\"actor %lld\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}", ev._actorID, pid, tid, ts);
+				break;
+			case trace_actor_yield:
+				fprintf(file, ",\n{\"ph\":\"E\",\"cat\":\"actor\",\"name\":\"actor %lld\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}", ev._actorID, pid, tid, ts);
+				break;
+			case trace_msg_send:
+			case trace_msg_recv:
+				{//流事件需要绑定到一个时间片上，用一个0长度的时间片承载
+					bool send = trace_msg_send == ev._type;
+					fprintf(file, ",\n{\"ph\":\"X\",\"cat\":\"msg\",\"name\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":0,\"args\":{\"actor\":%lld,\"flow\":%llu}}",
+						send ? "msg send" : "msg recv", pid, tid, ts, ev._actorID, ev._flow);
+					fprintf(file, ",\n{\"ph\":\"%s\",\"cat\":\"msg\",\"name\":\"msg\",\"id\":%llu,\"pid\":%u,\"tid\":%u,\"ts\":%.3f%s}",
+						send ? "s" : "f", ev._flow, pid, tid, ts, send ? "" : ",\"bp\":\"e\"");
+				}
+				break;
+			case trace_timer_fire:
+				fprintf(file, ",\n{\"ph\":\"i\",\"s\":\"t\",\"cat\":\"timer\",\"name\":\"timer\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"args\":{\"actor\":%lld}}", pid, tid, ts, ev._actorID);
+				break;
+			case trace_strand_post:
+				fprintf(file, ",\n{\"ph\":\"i\",\"s\":\"t\",\"cat\":\"strand\",\"name\":\"post\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}", pid, tid, ts);
+				break;
+			}
+		}
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+}
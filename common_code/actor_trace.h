@@ -0,0 +1,88 @@
+#ifndef __ACTOR_TRACE_H
+#define __ACTOR_TRACE_H
+
+#include <boost/atomic/atomic.hpp>
+#include <string>
+
+enum trace_event_type
+{
+	trace_actor_resume = 0,
+	trace_actor_yield,
+	trace_msg_send,
+	trace_msg_recv,
+	trace_timer_fire,
+	trace_strand_post
+};
+
+/*!
+@brief 一条跟踪事件，32字节
+*/
+struct trace_event
+{
+	unsigned long long _cycle;///<TSC时间戳
+	long long _actorID;
+	unsigned long long _flow;///<消息流ID，连接发送和接收
+	int _type;
+	int _reserved;
+};
+
+/*!
+@brief Actor调度时间线跟踪，记录Actor恢复/让出、消息发送/接收(带流ID)、定时器触发和strand投递，
+每个线程写自己的环形缓冲区(无锁，满了覆盖最旧的事件)，按需导出为Chrome trace JSON
+(chrome://tracing 或 ui.perfetto.dev 打开)
+*/
+class actor_trace
+{
+public:
+	/*!
+	@brief 启用跟踪，在创建Actor之前调用
+	@param eventsPerThread 每个线程缓冲的事件数，取整到2的幂
+	*/
+	static void enable(size_t eventsPerThread = 64*1024);
+
+	static bool enabled()
+	{
+		return _enabled;
+	}
+
+	/*!
+	@brief 暂停/恢复记录
+	*/
+	static void pause(bool paused);
+
+	/*!
+	@brief 记录一个事件，热点路径上先用 enabled() 判断再调用
+	*/
+	static void record(trace_event_type type, long long actorID, unsigned long long flow = 0);
+
+	/*!
+	@brief 记录消息发送，返回流ID，未启用时返回0
+	*/
+	static unsigned long long msg_send(long long actorID)
+	{
+		return _enabled ? record_send(actorID) : 0;
+	}
+
+	/*!
+	@brief 记录消息到达，flow为0时不记录
+	*/
+	static void msg_recv(long long actorID, unsigned long long flow)
+	{
+		if (flow)
+		{
+			record(trace_msg_recv, actorID, flow);
+		}
+	}
+
+	/*!
+	@brief 把所有线程缓冲的事件导出为Chrome trace JSON文件，不需要暂停，
+	复制期间被写线程覆盖的事件会被丢弃
+	*/
+	static bool dump_json(const char* fileName);
+private:
+	static unsigned long long record_send(long long actorID);
+private:
+	static bool _enabled;
+};
+
+#endif
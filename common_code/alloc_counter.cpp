@@ -0,0 +1,66 @@
+#include "alloc_counter.h"
+#include <stdlib.h>
+#include <new>
+#include <crtdbg.h>
+
+static __declspec(thread) long long _tlsAllocCount = 0;
+static __declspec(thread) long long _tlsAllocBytes = 0;
+
+long long alloc_counter::thread_count()
+{
+	return _tlsAllocCount;
+}
+
+long long alloc_counter::thread_bytes()
+{
+	return _tlsAllocBytes;
+}
+
+#ifdef _DEBUG
+static int __cdecl alloc_hook(int allocType, void* userData, size_t size, int blockType, long requestNumber, const unsigned char* fileName, int lineNumber)
+{
+	if ((_HOOK_ALLOC == allocType || _HOOK_REALLOC == allocType) && _CRT_BLOCK != _BLOCK_TYPE(blockType))
+	{
+		_tlsAllocCount++;
+		_tlsAllocBytes += size;
+	}
+	return TRUE;
+}
+
+static struct alloc_hook_install
+{
+	alloc_hook_install()
+	{
+		_CrtSetAllocHook(alloc_hook);
+	}
+} _allocHookInstall;
+#endif
+
+void* operator new(size_t size)
+{
+#ifndef _DEBUG
+	_tlsAllocCount++;
+	_tlsAllocBytes += size;
+#endif
+	void* p = malloc(size ? size : 1);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p)
+{
+	free(p);
+}
+
+void operator delete[](void* p)
+{
+	free(p);
+}
@@ -0,0 +1,23 @@
+#ifndef __ALLOC_COUNTER_H
+#define __ALLOC_COUNTER_H
+
+/*!
+@brief 按线程统计内存分配次数，用于检查热点路径是否有内存分配；
+只有链接了 alloc_counter.cpp 的程序(测试/基准程序)才会替换全局 operator new/delete，
+Debug版本通过CRT分配钩子统计，malloc 也计算在内，Release版本只统计 operator new
+*/
+class alloc_counter
+{
+public:
+	/*!
+	@brief 当前线程累计的分配次数
+	*/
+	static long long thread_count();
+
+	/*!
+	@brief 当前线程累计分配的字节数
+	*/
+	static long long thread_bytes();
+};
+
+#endif
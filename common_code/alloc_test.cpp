@@ -0,0 +1,245 @@
+#include "alloc_test.h"
+#include "alloc_counter.h"
+#include "socket_io.h"
+#include "acceptor_socket.h"
+#include <stdio.h>
+
+//预热次数，让各级内存池、asio的线程handler缓存到达稳定状态
+#define ALLOC_TEST_WARMUP	64
+
+/*
+每次操作允许的分配次数，热点路径改动后这里的数字变了说明引入(或消除)了分配
+make_trig_notifer 每次新建关闭标记 shared_ptr<bool>，一次 new bool 一次控制块
+*/
+#define WAIT_MSG_ALLOCS		0
+#define PUMP_MSG_ALLOCS		0
+#define SLEEP_ALLOCS		0
+#define DELAY_TRIG_ALLOCS	2
+#define SOCKET_READ_ALLOCS	0
+
+alloc_test::alloc_test(int ops, size_t port)
+:_ops(ops), _port(port)
+{
+	assert(ops > 0);
+}
+
+bool alloc_test::run(my_actor* self)
+{
+	assert(1 == self->self_strand()->ios_thread_number());
+	_results.clear();
+	test_wait_msg(self);
+	test_pump_msg(self);
+	test_sleep(self);
+	test_delay_trig(self);
+	test_socket_read(self);
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		if (!_results[i]._ok)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+const std::vector<alloc_result>& alloc_test::results()
+{
+	return _results;
+}
+
+std::string alloc_test::report()
+{
+	std::string res;
+	char buf[256];
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		const alloc_result& r = _results[i];
+		sprintf_s(buf, "%-12s %s  expected %lld/op, got %lld in %d ops\n", r._name.c_str(), r._ok ? "ok  " : "FAIL", r._expected, r._allocs, r._ops);
+		res += buf;
+	}
+	return res;
+}
+
+void alloc_test::check(const char* name, long long expected, long long allocs, int ops)
+{
+	alloc_result r;
+	r._name = name;
+	r._expected = expected;
+	r._allocs = allocs;
+	r._ops = ops;
+	r._ok = expected * ops == allocs;
+	_results.push_back(r);
+}
+
+void alloc_test::test_wait_msg(my_actor* self)
+{//同strand中 actor_msg_handle 往返一次
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	std::function<void (int)> toBuddy;
+	std::function<void (int)>* buddySlot = &toBuddy;
+	child_actor_handle buddy = self->create_child_actor([toSelf, buddySlot](my_actor* self)
+	{
+		actor_msg_handle<int> amh;
+		*buddySlot = self->make_msg_notifer(amh);
+		toSelf(-1);
+		while (true)
+		{
+			int i = self->wait_msg(amh);
+			if (i < 0)
+			{
+				break;
+			}
+			toSelf(i);
+		}
+		self->close_msg_notifer(amh);
+	});
+	self->child_actor_run(buddy);
+	self->wait_msg(amh);
+	for (int i = 0; i < ALLOC_TEST_WARMUP; i++)
+	{
+		toBuddy(i);
+		self->wait_msg(amh);
+	}
+	long long ct = alloc_counter::thread_count();
+	for (int i = 0; i < _ops; i++)
+	{
+		toBuddy(i);
+		self->wait_msg(amh);
+	}
+	ct = alloc_counter::thread_count() - ct;
+	toBuddy(-1);
+	self->child_actor_wait_quit(buddy);
+	self->close_msg_notifer(amh);
+	check("wait_msg", WAIT_MSG_ALLOCS, ct, _ops);
+}
+
+void alloc_test::test_pump_msg(my_actor* self)
+{//post_actor_msg 发过去，对方 pump_msg 后用 actor_msg_handle 回来
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	child_actor_handle buddy = self->create_child_actor([toSelf](my_actor* self)
+	{
+		auto pump = self->connect_msg_pump<int>();
+		while (true)
+		{
+			int i = 0;
+			self->pump_msg(pump, i);
+			if (i < 0)
+			{
+				break;
+			}
+			toSelf(i);
+		}
+	});
+	self->child_actor_run(buddy);
+	auto toBuddy = self->connect_msg_notifer_to<int>(buddy);
+	for (int i = 0; i < ALLOC_TEST_WARMUP; i++)
+	{
+		toBuddy(i);
+		self->wait_msg(amh);
+	}
+	long long ct = alloc_counter::thread_count();
+	for (int i = 0; i < _ops; i++)
+	{
+		toBuddy(i);
+		self->wait_msg(amh);
+	}
+	ct = alloc_counter::thread_count() - ct;
+	toBuddy(-1);
+	self->child_actor_wait_quit(buddy);
+	self->close_msg_notifer(amh);
+	check("pump_msg", PUMP_MSG_ALLOCS, ct, _ops);
+}
+
+void alloc_test::test_sleep(my_actor* self)
+{//sleep(0) 让出一次
+	for (int i = 0; i < ALLOC_TEST_WARMUP; i++)
+	{
+		self->sleep(0);
+	}
+	long long ct = alloc_counter::thread_count();
+	for (int i = 0; i < _ops; i++)
+	{
+		self->sleep(0);
+	}
+	ct = alloc_counter::thread_count() - ct;
+	check("sleep(0)", SLEEP_ALLOCS, ct, _ops);
+}
+
+void alloc_test::test_delay_trig(my_actor* self)
+{//make_trig_notifer + delay_trig(1ms) + wait_trig，定时器要真正走一遍，次数少一些
+	int ops = _ops < 200 ? _ops : 200;
+	actor_trig_handle<int> ath;
+	for (int i = 0; i < ALLOC_TEST_WARMUP / 4; i++)
+	{
+		self->make_trig_notifer(ath);
+		self->delay_trig(1, ath, i);
+		self->wait_trig(ath);
+	}
+	long long ct = alloc_counter::thread_count();
+	for (int i = 0; i < ops; i++)
+	{
+		self->make_trig_notifer(ath);
+		self->delay_trig(1, ath, i);
+		self->wait_trig(ath);
+	}
+	ct = alloc_counter::thread_count() - ct;
+	self->close_trig_notifer(ath);
+	check("delay_trig", DELAY_TRIG_ALLOCS, ct, ops);
+}
+
+void alloc_test::test_socket_read(my_actor* self)
+{//回环连接上一次读1字节，数据预先一次写好
+	const int total = ALLOC_TEST_WARMUP + _ops;
+	actor_msg_handle<socket_handle> smh;
+	accept_handle acceptor = acceptor_socket::create(self->self_strand(), _port, self->make_msg_notifer(smh));
+	if (!acceptor)
+	{
+		self->close_msg_notifer(smh);
+		check("socket_read", SOCKET_READ_ALLOCS, -1, 0);
+		return;
+	}
+	socket_handle client = socket_io::create(self->self_strand()->get_io_service());
+	actor_trig_handle<boost::system::error_code> ath;
+	client->async_connect("127.0.0.1", _port, self->make_trig_notifer(ath));
+	boost::system::error_code ec = self->wait_trig(ath);
+	socket_handle server;
+	if (!ec)
+	{
+		server = self->wait_msg(smh);
+	}
+	acceptor->close();
+	self->close_msg_notifer(smh);
+	if (ec || !server)
+	{
+		client->close();
+		check("socket_read", SOCKET_READ_ALLOCS, -1, 0);
+		return;
+	}
+	std::vector<unsigned char> data(total, 'x');
+	actor_trig_handle<boost::system::error_code, size_t> wth;
+	client->async_write(&data[0], data.size(), self->make_trig_notifer(wth));
+	size_t written = 0;
+	self->wait_trig(wth, ec, written);
+	actor_msg_handle<boost::system::error_code, size_t> rmh;
+	auto readNotify = self->make_msg_notifer(rmh);
+	unsigned char byte = 0;
+	long long ct = 0;
+	int ops = 0;
+	for (int i = 0; i < total && !ec; i++)
+	{
+		if (ALLOC_TEST_WARMUP == i)
+		{
+			ct = alloc_counter::thread_count();
+		}
+		size_t n = 0;
+		server->async_read_some(&byte, 1, readNotify);
+		self->wait_msg(rmh, ec, n);
+		ops = i + 1 - ALLOC_TEST_WARMUP;
+	}
+	ct = alloc_counter::thread_count() - ct;
+	self->close_msg_notifer(rmh);
+	client->close();
+	server->close();
+	check("socket_read", SOCKET_READ_ALLOCS, ec ? -1 : ct, ops);
+}
@@ -0,0 +1,53 @@
+#ifndef __ALLOC_TEST_H
+#define __ALLOC_TEST_H
+
+#include "actor_framework.h"
+#include <string>
+#include <vector>
+
+/*!
+@brief 一个分配计数用例的结果
+*/
+struct alloc_result
+{
+	std::string _name;
+	long long _expected;///<每次操作允许的分配次数
+	long long _allocs;///<实测总分配次数
+	int _ops;
+	bool _ok;
+};
+
+/*!
+@brief 热点路径分配次数测试，每个用例先预热，再执行 ops 次操作，总分配次数必须正好等于 预期*ops；
+需要链接 alloc_counter.cpp，运行 self 的调度器只能有一个线程(计数按线程统计)
+*/
+class alloc_test
+{
+public:
+	alloc_test(int ops = 1000, size_t port = 9127);
+public:
+	/*!
+	@brief 运行所有用例
+	@return 全部通过返回true
+	*/
+	bool run(my_actor* self);
+
+	/*!
+	@brief 测试报告
+	*/
+	std::string report();
+	const std::vector<alloc_result>& results();
+private:
+	void check(const char* name, long long expected, long long allocs, int ops);
+	void test_wait_msg(my_actor* self);
+	void test_pump_msg(my_actor* self);
+	void test_sleep(my_actor* self);
+	void test_delay_trig(my_actor* self);
+	void test_socket_read(my_actor* self);
+private:
+	int _ops;
+	size_t _port;
+	std::vector<alloc_result> _results;
+};
+
+#endif
@@ -6,7 +6,7 @@
 #include <memory>
 
 /*!
-@brief 첽Уͬһshared_strandʹ
+@brief 异步缓冲队列，在同一个shared_strand中使用
 */
 template <typename T>
 class async_buffer
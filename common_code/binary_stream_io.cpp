@@ -0,0 +1,185 @@
+#include "binary_stream_io.h"
+#include "scattered.h"
+
+#define BINARY_HEAD_SIZE		4
+#define BINARY_READ_BUFF_SIZE	(64 kB)
+
+static inline size_t get_frame_head(const unsigned char* p)
+{
+	return (size_t)p[0] | ((size_t)p[1] << 8) | ((size_t)p[2] << 16) | ((size_t)p[3] << 24);
+}
+
+static inline void set_frame_head(unsigned char* p, size_t length)
+{
+	p[0] = (unsigned char)length;
+	p[1] = (unsigned char)(length >> 8);
+	p[2] = (unsigned char)(length >> 16);
+	p[3] = (unsigned char)(length >> 24);
+}
+
+binary_stream_io::binary_stream_io()
+{
+	_closed = false;
+	_maxBatchBytes = 0;
+	_maxFrameLength = 0;
+}
+
+binary_stream_io::~binary_stream_io()
+{
+
+}
+
+std::shared_ptr<binary_stream_io> binary_stream_io::create( shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_data)>& h,
+	size_t maxBatchBytes, size_t maxFrameLength )
+{
+	assert(maxBatchBytes);
+	assert(maxFrameLength <= 1024 kB);
+	std::shared_ptr<binary_stream_io> res(new binary_stream_io);
+	res->_ioObj = ioObj;
+	res->_maxBatchBytes = maxBatchBytes;
+	res->_maxFrameLength = maxFrameLength;
+	res->_msgNotify = h;
+	auto wc = my_actor::create(strand, [res](my_actor* self){res->writeActor(self); });
+	res->_writerPipeIn = wc->make_msg_notifer(res->_writerPipeOut);
+	auto rc = my_actor::create(strand, [res](my_actor* self){res->readActor(self); });
+	wc->notify_run();
+	rc->notify_run();
+	return res;
+}
+
+void binary_stream_io::close()
+{
+	_ioObj->close();
+}
+
+bool binary_stream_io::write( shared_data msg )
+{
+	if (!_closed)
+	{
+		assert(msg->size() <= _maxFrameLength);
+		_writerPipeIn(msg);
+		return true;
+	}
+	return false;
+}
+
+void binary_stream_io::readActor( my_actor* self )
+{
+	shared_data buff = msg_data::create(BINARY_READ_BUFF_SIZE);
+	size_t dataLength = 0;//缓冲区中有效数据长度
+	bool error = false;
+	while (!error)
+	{
+		actor_trig_handle<boost::system::error_code, size_t> ath;
+		_ioObj->async_read_some((unsigned char*)buff->data()+dataLength, buff->size()-dataLength, self->make_trig_notifer(ath));
+		boost::system::error_code ec;
+		size_t length;
+		self->wait_trig(ath, ec, length);
+		if (ec || 0 == length)
+		{
+			break;
+		}
+		dataLength += length;
+		//一次读取中可能包含多帧，逐帧拆出
+		unsigned char* p = (unsigned char*)buff->data();
+		size_t pos = 0;
+		while (dataLength - pos >= BINARY_HEAD_SIZE)
+		{
+			size_t frameLength = get_frame_head(p+pos);
+			if (frameLength > _maxFrameLength)
+			{
+				_ioObj->close();
+				error = true;
+				break;
+			}
+			size_t bodyPos = pos + BINARY_HEAD_SIZE;
+			size_t hasLength = dataLength - bodyPos;
+			if (hasLength >= frameLength)
+			{
+				_msgNotify(msg_data::create(p+bodyPos, frameLength));
+				pos = bodyPos + frameLength;
+			}
+			else if (frameLength > buff->size() - BINARY_HEAD_SIZE)
+			{
+				//帧比读缓冲区大，剩余部分直接读到帧缓冲区
+				shared_data msg = msg_data::create(frameLength);
+				memcpy(msg->data(), p+bodyPos, hasLength);
+				actor_trig_handle<boost::system::error_code, size_t> bodyAth;
+				_ioObj->async_read((unsigned char*)msg->data()+hasLength, frameLength-hasLength, self->make_trig_notifer(bodyAth));
+				self->wait_trig(bodyAth, ec, length);
+				if (ec)
+				{
+					error = true;
+					break;
+				}
+				_msgNotify(msg);
+				pos = dataLength;
+			}
+			else
+			{
+				break;
+			}
+		}
+		if (pos)
+		{
+			memmove(p, p+pos, dataLength-pos);
+			dataLength -= pos;
+		}
+	}
+	_msgNotify(shared_data());
+	_writerPipeIn(shared_data());
+	clear_function(_msgNotify);
+}
+
+void binary_stream_io::writeActor( my_actor* self )
+{
+	std::vector<boost::asio::const_buffer> buffs;
+	std::vector<unsigned char> heads;
+	list<shared_data> batch;
+	bool exit = false;
+	while (!exit)
+	{
+		shared_data msg = self->wait_msg(_writerPipeOut);
+		if (!msg)
+		{
+			break;
+		}
+		//取出队列中所有待发消息，每帧"长度头+数据"组成一个gather列表，一次写出
+		size_t batchBytes = 0;
+		while (true)
+		{
+			batchBytes += msg->size()+BINARY_HEAD_SIZE;
+			batch.push_back(msg);
+			if (batchBytes >= _maxBatchBytes || !self->try_wait_msg(_writerPipeOut, msg))
+			{
+				break;
+			}
+			if (!msg)
+			{
+				exit = true;
+				break;
+			}
+		}
+		heads.resize(batch.size()*BINARY_HEAD_SIZE);
+		size_t i = 0;
+		for (auto it = batch.begin(); it != batch.end(); it++, i += BINARY_HEAD_SIZE)
+		{
+			set_frame_head(&heads[i], (*it)->size());
+			buffs.push_back(boost::asio::const_buffer(&heads[i], BINARY_HEAD_SIZE));
+			buffs.push_back(boost::asio::const_buffer((*it)->data(), (*it)->size()));
+		}
+		actor_trig_handle<boost::system::error_code, size_t> ath;
+		_ioObj->async_write(buffs, self->make_trig_notifer(ath));
+		boost::system::error_code ec;
+		size_t length;
+		self->wait_trig(ath, ec, length);
+		buffs.clear();
+		batch.clear();
+		if (ec)
+		{
+			break;
+		}
+	}
+	self->close_msg_notifer(_writerPipeOut);
+	_closed = true;
+}
@@ -0,0 +1,41 @@
+#ifndef __BINARY_STREAM_H
+#define __BINARY_STREAM_H
+
+#include "stream_io_base.h"
+#include "shared_data.h"
+#include "actor_framework.h"
+
+/*!
+@brief 二进制数据流解析类，每帧为4字节小端长度头+数据，接口与text_stream_io一致
+*/
+class binary_stream_io
+{
+private:
+	binary_stream_io();
+public:
+	~binary_stream_io();
+	/*!
+	@brief 创建二进制流
+	@param h 收到一帧数据时的回调，断开时参数为空
+	@param maxBatchBytes 写合并时单次写出的字节上限
+	@param maxFrameLength 单帧最大长度(不超过1M)，超过时断开
+	*/
+	static std::shared_ptr<binary_stream_io> create(shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_data)>& h,
+		size_t maxBatchBytes = 64 kB, size_t maxFrameLength = 1024 kB);
+public:
+	void close();
+	bool write(shared_data msg);
+private:
+	void readActor(my_actor* self);
+	void writeActor(my_actor* self);
+private:
+	bool _closed;
+	size_t _maxBatchBytes;
+	size_t _maxFrameLength;
+	std::shared_ptr<stream_io_base> _ioObj;
+	std::function<void (shared_data)> _msgNotify;
+	std::function<void (shared_data)> _writerPipeIn;
+	actor_msg_handle<shared_data> _writerPipeOut;
+};
+
+#endif
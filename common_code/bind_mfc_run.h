@@ -53,7 +53,7 @@ public:
 	virtual ~bind_mfc_run() {};
 public:
 	/*!
-	@brief һMFCִ
+	@brief 绑定一个函数到MFC队列执行
 	*/
 	template <typename Handler>
 	wrapped_post_handler<bind_mfc_run, Handler> wrap(const Handler& handler)
@@ -73,7 +73,7 @@ protected:
 	}
 
 	/*!
-	@brief رջֹ࣬ϢͶ
+	@brief 关闭基类，并且终止消息的投递
 	*/
 	void mfc_close()
 	{
@@ -83,7 +83,7 @@ protected:
 	}
 public:
 	/*!
-	@brief MFC̳߳ʼʱ
+	@brief 在MFC主线程初始化时调用
 	*/
 	void set_thread_id()
 	{
@@ -91,7 +91,7 @@ public:
 	}
 
 	/*!
-	@brief ȡ߳ID
+	@brief 获取主线程ID
 	*/
 	boost::thread::id thread_id()
 	{
@@ -100,7 +100,7 @@ public:
 	}
 
 	/*!
-	@brief һִкMFCϢִ
+	@brief 发送一个执行函数到MFC消息队列中执行
 	*/
 	void post(const std::function<void ()>& h)
 	{
@@ -115,7 +115,7 @@ public:
 	}
 	
 	/*!
-	@brief һִкMFCϢִУɺ󷵻
+	@brief 发送一个执行函数到MFC消息队列中执行，完成后返回
 	*/
 	void send(my_actor* self, const std::function<void ()>& h)
 	{
@@ -139,7 +139,7 @@ public:
 	}
 
 	/*!
-	@brief һֵMFCϢִУɺ󷵻
+	@brief 发送一个带返回值函数到MFC消息队列中执行，完成后返回
 	*/
 	template <typename T>
 	T send(my_actor* self, const std::function<T ()>& h)
@@ -168,8 +168,8 @@ public:
 	}
 #ifdef ENABLE_MFC_ACTOR
 	/*!
-	@brief MFC߳дһActor
-	@param ios ActorڲtimerʹõĵûоͲtimer
+	@brief 在MFC线程中创建一个Actor
+	@param ios Actor内部timer使用的调度器，没有就不能用timer
 	*/
 	actor_handle create_mfc_actor(ios_proxy& ios, const my_actor::main_func& mainFunc, size_t stackSize = DEFAULT_STACKSIZE)
 	{
@@ -0,0 +1,457 @@
+#include "durable_mailbox.h"
+#include "scattered.h"
+
+#define JOURNAL_MAGIC		0x4C4E524A
+#define JOURNAL_HEAD_SIZE	64
+#define JOURNAL_RECORD_HEAD	16
+#define JOURNAL_WRAP		0xFFFFFFFF
+#define JOURNAL_ALIGN(__n__)	(((__n__) + 7) & ~(unsigned long long)7)
+#define JOURNAL_CLOSE_SEQ	((unsigned long long)-1)
+
+/*!
+@brief 日志文件头，_begin 为第一个未确认记录的位置，其序号为 _beginSeq；
+确认只在内存中移动 _begin，释放出的空间要等头刷盘后才会被新记录覆盖
+*/
+struct journal_head
+{
+	unsigned _magic;
+	unsigned _version;
+	unsigned long long _capacity;
+	unsigned long long _begin;
+	unsigned long long _beginSeq;
+	unsigned long long _ackedSeq;
+};
+
+/*!
+@brief 记录头，后面紧跟消息体，按8字节对齐；
+_length 为 JOURNAL_WRAP 时表示回绕到数据区开头；
+恢复时序号不连续或校验不符即为日志结尾，不需要单独刷写结尾位置
+*/
+struct journal_record
+{
+	unsigned _length;
+	unsigned _check;
+	unsigned long long _seq;
+};
+
+static unsigned journal_check(unsigned long long seq, const void* data, size_t length)
+{
+	//FNV-1a
+	unsigned h = 2166136261u;
+	const unsigned char* ps = (const unsigned char*)&seq;
+	for (size_t i = 0; i < sizeof(seq); i++)
+	{
+		h = (h ^ ps[i]) * 16777619u;
+	}
+	const unsigned char* p = (const unsigned char*)data;
+	for (size_t i = 0; i < length; i++)
+	{
+		h = (h ^ p[i]) * 16777619u;
+	}
+	return h;
+}
+
+durable_mailbox::durable_mailbox()
+: _ios(1)
+{
+	_closed = true;
+	_closeDropped = 0;
+	_file = INVALID_HANDLE_VALUE;
+	_mapping = NULL;
+	_head = NULL;
+	_capacity = 0;
+	_begin = _end = JOURNAL_HEAD_SIZE;
+	_beginSeq = _nextSeq = 1;
+	_ackedSeq = 0;
+	_dirtyBegin = JOURNAL_HEAD_SIZE;
+	_headDirty = false;
+	_commitMs = 0;
+}
+
+durable_mailbox::~durable_mailbox()
+{
+	close();
+	if (_head)
+	{
+		UnmapViewOfFile(_head);
+	}
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+	}
+	if (INVALID_HANDLE_VALUE != _file)
+	{
+		CloseHandle(_file);
+	}
+}
+
+std::shared_ptr<durable_mailbox> durable_mailbox::create(const char* fileName, const std::function<void (unsigned long long, shared_data)>& h, size_t capacity, int commitMs)
+{
+	assert(capacity >= 64*1024 && commitMs >= 0);
+	std::shared_ptr<durable_mailbox> res(new durable_mailbox);
+	res->_file = CreateFileA(fileName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == res->_file)
+	{
+		return std::shared_ptr<durable_mailbox>();
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(res->_file, &fileSize);
+	unsigned long long mapSize = (unsigned long long)fileSize.QuadPart >= capacity ? fileSize.QuadPart : capacity;
+	res->_mapping = CreateFileMappingA(res->_file, NULL, PAGE_READWRITE, (DWORD)(mapSize >> 32), (DWORD)mapSize, NULL);
+	if (!res->_mapping)
+	{
+		return std::shared_ptr<durable_mailbox>();
+	}
+	res->_head = (journal_head*)MapViewOfFile(res->_mapping, FILE_MAP_ALL_ACCESS, 0, 0, (size_t)mapSize);
+	if (!res->_head)
+	{
+		return std::shared_ptr<durable_mailbox>();
+	}
+	if (JOURNAL_MAGIC != res->_head->_magic)
+	{
+		res->_head->_magic = JOURNAL_MAGIC;
+		res->_head->_version = 1;
+		res->_head->_capacity = mapSize;
+		res->_head->_begin = JOURNAL_HEAD_SIZE;
+		res->_head->_beginSeq = 1;
+		res->_head->_ackedSeq = 0;
+	}
+	res->_capacity = res->_head->_capacity;
+	res->_commitMs = commitMs;
+	res->_msgNotify = h;
+	res->recover();
+	res->_ios.run(1);
+	durable_mailbox* mailbox = res.get();
+	res->_actor = my_actor::create(boost_strand::create(res->_ios), [mailbox](my_actor* self){mailbox->journalActor(self); });
+	res->_journalPipeIn = res->_actor->make_msg_notifer(res->_journalPipeOut);
+	res->_closed = false;
+	res->_actor->notify_run();
+	return res;
+}
+
+char* durable_mailbox::at(unsigned long long pos)
+{
+	return (char*)_head + (size_t)pos;
+}
+
+void durable_mailbox::recover()
+{
+	_begin = _head->_begin;
+	_beginSeq = _head->_beginSeq;
+	_ackedSeq = _head->_ackedSeq;
+	unsigned long long pos = _begin;
+	unsigned long long seq = _beginSeq;
+	while (true)
+	{
+		if (_capacity - pos < JOURNAL_RECORD_HEAD)
+		{
+			pos = JOURNAL_HEAD_SIZE;
+		}
+		journal_record* rec = (journal_record*)at(pos);
+		if (rec->_seq != seq)
+		{
+			break;
+		}
+		if (JOURNAL_WRAP == rec->_length)
+		{
+			pos = JOURNAL_HEAD_SIZE;
+			continue;
+		}
+		if (rec->_length > _capacity - pos - JOURNAL_RECORD_HEAD || rec->_check != journal_check(seq, rec + 1, rec->_length))
+		{
+			break;
+		}
+		if (seq > _ackedSeq)
+		{
+			_msgNotify(seq, msg_data::create(rec + 1, rec->_length));
+		}
+		pos += JOURNAL_ALIGN(JOURNAL_RECORD_HEAD + rec->_length);
+		seq++;
+	}
+	_end = pos;
+	_nextSeq = seq;
+	_dirtyBegin = _end;
+}
+
+void durable_mailbox::post(shared_data msg)
+{
+	assert(msg && msg->size() < 0xFFFFFFFF);
+	if (!_closed)
+	{
+		_journalPipeIn(msg, 0);
+	}
+}
+
+void durable_mailbox::ack(unsigned long long seq)
+{
+	if (!_closed && seq)
+	{
+		_journalPipeIn(shared_data(), seq);
+	}
+}
+
+size_t durable_mailbox::close()
+{
+	if (!_closed)
+	{
+		_closed = true;
+		assert(!_ios.runningInThisIos());
+		_journalPipeIn(shared_data(), JOURNAL_CLOSE_SEQ);
+		_actor->outside_wait_quit();
+		_ios.stop();
+		clear_function(_journalPipeIn);
+		_actor.reset();
+	}
+	return _closeDropped;
+}
+
+void durable_mailbox::advance(unsigned long long ackSeq)
+{
+	if (ackSeq >= _nextSeq)
+	{
+		ackSeq = _nextSeq - 1;
+	}
+	if (ackSeq <= _ackedSeq)
+	{
+		return;
+	}
+	_ackedSeq = ackSeq;
+	//跳过已确认的记录，空出日志空间
+	while (_beginSeq <= _ackedSeq)
+	{
+		if (_capacity - _begin < JOURNAL_RECORD_HEAD)
+		{
+			_begin = JOURNAL_HEAD_SIZE;
+		}
+		journal_record* rec = (journal_record*)at(_begin);
+		if (JOURNAL_WRAP == rec->_length)
+		{
+			_begin = JOURNAL_HEAD_SIZE;
+			continue;
+		}
+		_begin += JOURNAL_ALIGN(JOURNAL_RECORD_HEAD + rec->_length);
+		_beginSeq++;
+	}
+	_headDirty = true;
+}
+
+bool durable_mailbox::reserve(unsigned long long need)
+{
+	//只能复用已刷盘的头之前的空间，头刷盘前崩溃时恢复从旧的 _begin 开始，那段记录必须还在
+	unsigned long long bound = _head->_begin;
+	bool empty = _head->_beginSeq == _nextSeq;
+	if (empty || _end >= bound)
+	{
+		if (_end + need <= _capacity)
+		{
+			return true;
+		}
+		//回绕标记在 bound(为空时就是 _end)处，回绕后不能覆盖它
+		if (JOURNAL_HEAD_SIZE + need >= bound)
+		{
+			return false;
+		}
+		if (_capacity - _end >= JOURNAL_RECORD_HEAD)
+		{
+			journal_record* wrap = (journal_record*)at(_end);
+			wrap->_length = JOURNAL_WRAP;
+			wrap->_check = 0;
+			wrap->_seq = _nextSeq;
+			_end += JOURNAL_RECORD_HEAD;
+		}
+		flush_view();
+		_end = JOURNAL_HEAD_SIZE;
+		_dirtyBegin = _end;
+		return true;
+	}
+	//留出间隙，写指针不追上第一个未确认记录
+	return _end + need < bound;
+}
+
+void durable_mailbox::persist_head()
+{
+	flush_view();
+	_head->_begin = _begin;
+	_head->_beginSeq = _beginSeq;
+	_head->_ackedSeq = _ackedSeq;
+	FlushViewOfFile(_head, JOURNAL_HEAD_SIZE);
+	FlushFileBuffers(_file);
+	_headDirty = false;
+}
+
+bool durable_mailbox::append(const shared_data& msg)
+{
+	unsigned long long need = JOURNAL_ALIGN(JOURNAL_RECORD_HEAD + msg->size());
+	assert(need <= _capacity - JOURNAL_HEAD_SIZE);
+	if (!reserve(need))
+	{
+		if (!_headDirty && (_beginSeq != _nextSeq || JOURNAL_HEAD_SIZE == _end))
+		{//没有只在内存中释放的空间
+			return false;
+		}
+		if (_beginSeq == _nextSeq)
+		{//全部已确认，从头开始
+			flush_view();
+			_begin = _end = JOURNAL_HEAD_SIZE;
+			_dirtyBegin = _end;
+		}
+		//确认释放的空间要等头刷盘后才能复用
+		persist_head();
+		if (!reserve(need))
+		{
+			return false;
+		}
+	}
+	bool empty = _beginSeq == _nextSeq;
+	if (empty)
+	{
+		_begin = _end;
+		_beginSeq = _nextSeq;
+		_headDirty = true;
+	}
+	journal_record* rec = (journal_record*)at(_end);
+	memcpy(rec + 1, msg->data(), msg->size());
+	rec->_length = (unsigned)msg->size();
+	rec->_check = journal_check(_nextSeq, msg->data(), msg->size());
+	rec->_seq = _nextSeq;
+	_batch.push_back(std::make_pair(_nextSeq, msg));
+	_nextSeq++;
+	_end += need;
+	return true;
+}
+
+bool durable_mailbox::flush_view()
+{
+	bool flushed = false;
+	if (_end > _dirtyBegin)
+	{
+		FlushViewOfFile(at(_dirtyBegin), (size_t)(_end - _dirtyBegin));
+		flushed = true;
+	}
+	_dirtyBegin = _end;
+	return flushed;
+}
+
+void durable_mailbox::commit()
+{
+	bool flushed = flush_view();
+	if (_headDirty)
+	{
+		_head->_begin = _begin;
+		_head->_beginSeq = _beginSeq;
+		_head->_ackedSeq = _ackedSeq;
+		FlushViewOfFile(_head, JOURNAL_HEAD_SIZE);
+		_headDirty = false;
+		flushed = true;
+	}
+	if (flushed || !_batch.empty())
+	{
+		//一批只刷一次盘
+		FlushFileBuffers(_file);
+	}
+	while (!_batch.empty())
+	{
+		_msgNotify(_batch.front().first, _batch.front().second);
+		_batch.pop_front();
+	}
+}
+
+void durable_mailbox::journalActor(my_actor* self)
+{
+	list<shared_data> backlog;
+	bool exit = false;
+	while (!exit)
+	{
+		shared_data msg;
+		unsigned long long seq = 0;
+		if (backlog.empty())
+		{
+			if (_headDirty)
+			{//只有确认没有新消息时，空闲一段时间后把确认位置写盘
+				if (!self->timed_wait_msg(_commitMs > 0 ? _commitMs : 1, _journalPipeOut, msg, seq))
+				{
+					commit();
+					continue;
+				}
+			}
+			else
+			{
+				self->wait_msg(_journalPipeOut, msg, seq);
+			}
+		}
+		else
+		{
+			msg = backlog.front();
+			backlog.pop_front();
+		}
+		//组提交窗口：收集窗口内的所有消息，一次刷盘
+		long long deadline = get_tick_ms() + _commitMs;
+		while (true)
+		{
+			if (msg)
+			{
+				if (!append(msg))
+				{//日志满，先提交已有的，等待消费者确认
+					commit();
+					backlog.push_front(msg);
+					while (!exit)
+					{
+						self->wait_msg(_journalPipeOut, msg, seq);
+						if (msg)
+						{
+							backlog.push_back(msg);
+							continue;
+						}
+						if (JOURNAL_CLOSE_SEQ == seq)
+						{
+							exit = true;
+							break;
+						}
+						unsigned long long oldBegin = _beginSeq;
+						advance(seq);
+						if (oldBegin != _beginSeq)
+						{
+							break;
+						}
+					}
+					break;
+				}
+			}
+			else if (JOURNAL_CLOSE_SEQ == seq)
+			{
+				exit = true;
+				break;
+			}
+			else
+			{
+				advance(seq);
+			}
+			if (!backlog.empty())
+			{
+				msg = backlog.front();
+				backlog.pop_front();
+				continue;
+			}
+			if (self->try_wait_msg(_journalPipeOut, msg, seq))
+			{
+				continue;
+			}
+			long long tm = deadline - get_tick_ms();
+			if (tm <= 0 || _batch.empty() || !self->timed_wait_msg((int)tm, _journalPipeOut, msg, seq))
+			{
+				break;
+			}
+		}
+		if (!_batch.empty())
+		{
+			commit();
+		}
+	}
+	//日志满时关闭，确认不会再来，剩下的消息写不进去
+	_closeDropped = backlog.size();
+	_headDirty = true;
+	commit();
+	self->close_msg_notifer(_journalPipeOut);
+	_msgNotify(0, shared_data());
+	clear_function(_msgNotify);
+}
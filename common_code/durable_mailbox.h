@@ -0,0 +1,79 @@
+#ifndef __DURABLE_MAILBOX_H
+#define __DURABLE_MAILBOX_H
+
+#include "actor_framework.h"
+#include "ios_proxy.h"
+#include "shared_data.h"
+
+struct journal_head;
+
+/*!
+@brief 持久化邮箱，消息先追加到内存映射的环形日志文件，按批一次刷盘(组提交)后才投递给消费者；
+消费者处理完后用 ack 确认序号，重启时未确认的消息重新投递(至少一次)
+*/
+class durable_mailbox
+{
+private:
+	durable_mailbox();
+public:
+	~durable_mailbox();
+	/*!
+	@brief 打开/创建日志文件，先重放上次未确认的消息
+	@param h 消息投递回调(序号, 消息)，可直接传入make_msg_notifer或连接到msg_pump，关闭时消息为空
+	@param capacity 日志文件大小，同时未确认的消息总量不能超过它
+	@param commitMs 组提交窗口，收到第一个消息后最多再等这么久把同一批消息一次刷盘
+	@return 打开文件失败返回空
+	*/
+	static std::shared_ptr<durable_mailbox> create(const char* fileName, const std::function<void (unsigned long long, shared_data)>& h,
+		size_t capacity = 64*1024*1024, int commitMs = 2);
+public:
+	/*!
+	@brief 投递一个消息，可在任何线程调用；日志满时等待消费者确认
+	*/
+	void post(shared_data msg);
+
+	/*!
+	@brief 确认序号 seq 及之前的所有消息已处理
+	*/
+	void ack(unsigned long long seq);
+
+	/*!
+	@brief 把已写入日志的消息提交、确认位置刷盘后关闭，不能在邮箱调度器中调用；
+	关闭后不再接收 ack，日志满时还在等待空间的消息不会写入，直接丢弃
+	@return 因日志满被丢弃的消息数
+	*/
+	size_t close();
+private:
+	void journalActor(my_actor* self);
+	void recover();
+	bool reserve(unsigned long long need);
+	void persist_head();
+	bool append(const shared_data& msg);
+	void advance(unsigned long long ackSeq);
+	bool flush_view();
+	void commit();
+	char* at(unsigned long long pos);
+private:
+	bool _closed;
+	size_t _closeDropped;
+	HANDLE _file;
+	HANDLE _mapping;
+	journal_head* _head;
+	unsigned long long _capacity;
+	unsigned long long _begin;
+	unsigned long long _beginSeq;
+	unsigned long long _end;
+	unsigned long long _nextSeq;
+	unsigned long long _ackedSeq;
+	unsigned long long _dirtyBegin;
+	bool _headDirty;
+	int _commitMs;
+	list<std::pair<unsigned long long, shared_data> > _batch;
+	std::function<void (unsigned long long, shared_data)> _msgNotify;
+	std::function<void (shared_data, unsigned long long)> _journalPipeIn;
+	actor_msg_handle<shared_data, unsigned long long> _journalPipeOut;
+	actor_handle _actor;
+	ios_proxy _ios;
+};
+
+#endif
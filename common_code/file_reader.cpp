@@ -0,0 +1,155 @@
+#include "file_reader.h"
+#include "scattered.h"
+
+#define FILE_READER_YIELD_LINES	1024
+
+struct file_reader::map_view
+{
+	map_view(void* base)
+		: _base(base) {}
+
+	~map_view()
+	{
+		UnmapViewOfFile(_base);
+	}
+
+	void* _base;
+};
+
+file_reader::file_reader()
+{
+	_closed = false;
+	_overflow = false;
+	_file = INVALID_HANDLE_VALUE;
+	_mapping = NULL;
+	_fileSize = 0;
+	_windowSize = 0;
+}
+
+file_reader::~file_reader()
+{
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+	}
+	if (INVALID_HANDLE_VALUE != _file)
+	{
+		CloseHandle(_file);
+	}
+}
+
+std::shared_ptr<file_reader> file_reader::create(shared_strand strand, const char* fileName, const std::function<void (shared_data)>& h, size_t windowSize)
+{
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	assert(windowSize >= 2 * si.dwAllocationGranularity);
+	std::shared_ptr<file_reader> res(new file_reader);
+	//顺序访问提示，让系统加大预读
+	res->_file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (INVALID_HANDLE_VALUE == res->_file)
+	{
+		return std::shared_ptr<file_reader>();
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(res->_file, &fileSize))
+	{
+		return std::shared_ptr<file_reader>();
+	}
+	res->_fileSize = fileSize.QuadPart;
+	if (res->_fileSize)
+	{
+		res->_mapping = CreateFileMappingA(res->_file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (!res->_mapping)
+		{
+			return std::shared_ptr<file_reader>();
+		}
+	}
+	res->_windowSize = windowSize - windowSize % si.dwAllocationGranularity;
+	res->_lineNotify = h;
+	my_actor::create(strand, [res](my_actor* self){res->readActor(self); })->notify_run();
+	return res;
+}
+
+void file_reader::close()
+{
+	_closed = true;
+}
+
+unsigned long long file_reader::file_size()
+{
+	return _fileSize;
+}
+
+bool file_reader::overflow()
+{
+	return _overflow;
+}
+
+shared_data file_reader::slice(const std::shared_ptr<map_view>& view, const char* p, size_t length)
+{
+	shared_data ref = msg_data::create_ref(p, length);
+	msg_data* pref = ref.get();
+	//引用计数中带上映射窗口
+	return shared_data(pref, [ref, view](msg_data*){});
+}
+
+void file_reader::readActor(my_actor* self)
+{
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	const unsigned long long granularity = si.dwAllocationGranularity;
+	unsigned long long pos = 0;
+	size_t lineCount = 0;
+	while (pos < _fileSize && !_closed)
+	{
+		//窗口起点按分配粒度对齐，跨窗口的半行在下一个窗口中完整读出
+		unsigned long long viewStart = pos - pos % granularity;
+		unsigned long long restSize = _fileSize - viewStart;
+		size_t viewSize = restSize < _windowSize ? (size_t)restSize : _windowSize;
+		void* base = MapViewOfFile(_mapping, FILE_MAP_READ, (DWORD)(viewStart >> 32), (DWORD)viewStart, viewSize);
+		if (!base)
+		{
+			break;
+		}
+		std::shared_ptr<map_view> view(new map_view(base));
+		const char* begin = (const char*)base + (size_t)(pos - viewStart);
+		const char* end = (const char*)base + viewSize;
+		const char* lineBegin = begin;
+		while (lineBegin != end && !_closed)
+		{
+			size_t n = find_crlf(lineBegin, end - lineBegin);
+			if (lineBegin + n == end)
+			{
+				break;
+			}
+			if (n)
+			{
+				_lineNotify(slice(view, lineBegin, n));
+				if (0 == ++lineCount % FILE_READER_YIELD_LINES)
+				{
+					self->sleep(0);
+				}
+			}
+			lineBegin += n + 1;
+		}
+		if (viewStart + viewSize == _fileSize)
+		{
+			if (lineBegin != end && !_closed)
+			{
+				_lineNotify(slice(view, lineBegin, end - lineBegin));
+			}
+			pos = _fileSize;
+		}
+		else if (lineBegin == begin && !_closed)
+		{//整个窗口中没有一个完整行
+			_overflow = true;
+			break;
+		}
+		else
+		{
+			pos = viewStart + (lineBegin - (const char*)base);
+		}
+	}
+	_lineNotify(shared_data());
+	clear_function(_lineNotify);
+}
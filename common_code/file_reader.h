@@ -0,0 +1,46 @@
+#ifndef __FILE_READER_H
+#define __FILE_READER_H
+
+#include "actor_framework.h"
+#include "shared_data.h"
+
+/*!
+@brief 内存映射文件逐行读取，在strand中运行一个读Actor，按窗口映射文件，
+每行以不拷贝的msg_data(引用映射内存，不以'\0'结尾)通知，读完或出错时参数为空
+*/
+class file_reader
+{
+	struct map_view;
+private:
+	file_reader();
+public:
+	~file_reader();
+	/*!
+	@brief 打开文件开始读取
+	@param h 行回调，消息包持有映射窗口，释放后窗口才解除映射
+	@param windowSize 每次映射的字节数，单行长度不能超过窗口大小减去分配粒度(64K)
+	@return 打开文件失败返回空
+	*/
+	static std::shared_ptr<file_reader> create(shared_strand strand, const char* fileName, const std::function<void (shared_data)>& h, size_t windowSize = 64*1024*1024);
+public:
+	void close();
+	unsigned long long file_size();
+
+	/*!
+	@brief 是否因单行超长而提前结束
+	*/
+	bool overflow();
+private:
+	void readActor(my_actor* self);
+	static shared_data slice(const std::shared_ptr<map_view>& view, const char* p, size_t length);
+private:
+	bool _closed;
+	bool _overflow;
+	HANDLE _file;
+	HANDLE _mapping;
+	unsigned long long _fileSize;
+	size_t _windowSize;
+	std::function<void (shared_data)> _lineNotify;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef __HANDLER_ALLOCATOR_H
+#define __HANDLER_ALLOCATOR_H
+
+#include <boost/aligned_storage.hpp>
+#include <boost/asio/handler_alloc_hook.hpp>
+#include <boost/asio/handler_invoke_hook.hpp>
+#include <boost/asio/detail/handler_invoke_helpers.hpp>
+#include <new>
+
+/*!
+@brief 异步操作对象的内存块，同一时刻只有一个操作在使用时反复复用同一块内存，被占用或不够大时从堆分配
+*/
+template <size_t Size = 512>
+class handler_allocator
+{
+public:
+	handler_allocator()
+		: _inUse(false) {}
+private:
+	handler_allocator(const handler_allocator&);
+	handler_allocator& operator =(const handler_allocator&);
+public:
+	void* allocate(size_t size)
+	{
+		if (!_inUse && size <= sizeof(_storage))
+		{
+			_inUse = true;
+			return _storage.address();
+		}
+		return ::operator new(size);
+	}
+
+	void deallocate(void* p)
+	{
+		if (p == _storage.address())
+		{
+			_inUse = false;
+		}
+		else
+		{
+			::operator delete(p);
+		}
+	}
+private:
+	boost::aligned_storage<Size> _storage;
+	bool _inUse;
+};
+
+/*!
+@brief 把asio为Handler分配的操作对象放到指定的handler_allocator中
+*/
+template <typename Allocator, typename Handler>
+class custom_alloc_handler
+{
+public:
+	custom_alloc_handler(Allocator& allocator, const Handler& handler)
+		: _allocator(&allocator),
+		_handler(handler)
+	{
+	}
+
+	void operator()()
+	{
+		_handler();
+	}
+
+	template <typename Arg1>
+	void operator()(const Arg1& arg1)
+	{
+		_handler(arg1);
+	}
+
+	template <typename Arg1, typename Arg2>
+	void operator()(const Arg1& arg1, const Arg2& arg2)
+	{
+		_handler(arg1, arg2);
+	}
+
+	friend void* asio_handler_allocate(size_t size, custom_alloc_handler* this_handler)
+	{
+		return this_handler->_allocator->allocate(size);
+	}
+
+	friend void asio_handler_deallocate(void* p, size_t, custom_alloc_handler* this_handler)
+	{
+		this_handler->_allocator->deallocate(p);
+	}
+
+	template <typename Function>
+	friend void asio_handler_invoke(Function& function, custom_alloc_handler* this_handler)
+	{
+		boost_asio_handler_invoke_helpers::invoke(function, this_handler->_handler);
+	}
+
+	template <typename Function>
+	friend void asio_handler_invoke(const Function& function, custom_alloc_handler* this_handler)
+	{
+		boost_asio_handler_invoke_helpers::invoke(function, this_handler->_handler);
+	}
+
+	Allocator* _allocator;
+	Handler _handler;
+};
+
+template <typename Allocator, typename Handler>
+inline custom_alloc_handler<Allocator, Handler> make_alloc_handler(Allocator& allocator, const Handler& handler)
+{
+	return custom_alloc_handler<Allocator, Handler>(allocator, handler);
+}
+
+#endif
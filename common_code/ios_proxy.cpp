@@ -1,19 +1,234 @@
 #include "ios_proxy.h"
 #include "shared_data.h"
 #include "mem_pool.h"
+#include "actor_metrics.h"
+#include "scattered.h"
 #include <boost/asio/high_resolution_timer.hpp>
 #include <boost/asio/detail/strand_service.hpp>
 #include <memory>
+#include <vector>
+#include <DbgHelp.h>
+#include <Psapi.h>
+
+#pragma comment( lib, "DbgHelp.lib" )
+#pragma comment( lib, "Psapi.lib" )
 
 typedef boost::asio::detail::strand_service::strand_impl impl_type;
 typedef boost::asio::basic_waitable_timer<boost::chrono::high_resolution_clock> timer_type;
 
-ios_proxy::ios_proxy()
+boost::atomic<int> ios_proxy::_watchingCount(0);
+static __declspec(thread) void* _tlsWatchSlot = NULL;
+
+#ifdef _WIN64
+struct image_pdata
+{
+	DWORD64 _base;
+	DWORD64 _end;
+	PRUNTIME_FUNCTION _funcs;
+	size_t _count;
+};
+
+/*!
+@brief 在挂起目标线程之前记录各模块的地址范围和函数表(.pdata)，回溯时自己查找函数项；
+RtlLookupFunctionEntry 要取加载器的函数表锁，目标线程可能正持有该锁，挂起期间调用会死锁
+*/
+static void snapshot_images(std::vector<image_pdata>& images)
+{
+	HMODULE mods[512];
+	DWORD needed = 0;
+	if (!EnumProcessModules(GetCurrentProcess(), mods, sizeof(mods), &needed))
+	{
+		return;
+	}
+	size_t modCount = needed / sizeof(HMODULE);
+	modCount = modCount < sizeof(mods) / sizeof(mods[0]) ? modCount : sizeof(mods) / sizeof(mods[0]);
+	images.reserve(modCount);
+	for (size_t i = 0; i < modCount; i++)
+	{
+		MODULEINFO modInfo;
+		if (!GetModuleInformation(GetCurrentProcess(), mods[i], &modInfo, sizeof(modInfo)))
+		{
+			continue;
+		}
+		ULONG size = 0;
+		image_pdata image;
+		image._base = (DWORD64)modInfo.lpBaseOfDll;
+		image._end = image._base + modInfo.SizeOfImage;
+		image._funcs = (PRUNTIME_FUNCTION)ImageDirectoryEntryToData(mods[i], TRUE, IMAGE_DIRECTORY_ENTRY_EXCEPTION, &size);
+		image._count = image._funcs ? size / sizeof(RUNTIME_FUNCTION) : 0;
+		images.push_back(image);
+	}
+}
+
+/*!
+@brief 在快照的函数表中二分查找 pc 所在函数，不取任何锁
+@param imageBase 所在模块基址，pc 不在任何已知模块中时为0
+*/
+static PRUNTIME_FUNCTION lookup_function(const std::vector<image_pdata>& images, DWORD64 pc, DWORD64& imageBase)
+{
+	imageBase = 0;
+	for (auto it = images.begin(); it != images.end(); it++)
+	{
+		if (pc < it->_base || pc >= it->_end)
+		{
+			continue;
+		}
+		imageBase = it->_base;
+		DWORD rva = (DWORD)(pc - it->_base);
+		size_t low = 0;
+		size_t high = it->_count;
+		while (low < high)
+		{
+			size_t mid = (low + high) / 2;
+			PRUNTIME_FUNCTION func = it->_funcs + mid;
+			if (rva < func->BeginAddress)
+			{
+				high = mid;
+			}
+			else if (rva >= func->EndAddress)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				return func;
+			}
+		}
+		break;
+	}
+	return NULL;
+}
+#endif
+
+/*!
+@brief 从挂起线程的上下文回溯返回地址，只读栈内存和模块函数表，不调用任何可能取锁的接口
+(DbgHelp、RtlLookupFunctionEntry 会取堆锁或加载器锁，目标线程可能正持有)；x86下依赖帧指针；
+模块在快照之后被卸载或 pc 不在已知模块中时停止，结果是尽力而为的
+@param images 挂起前取得的模块快照(仅x64使用)
+@return 取到的地址数
+*/
+#ifdef _WIN64
+static size_t unwind_context(const std::vector<image_pdata>& images, CONTEXT& context, DWORD64* pcs, size_t maxCount)
+#else
+static size_t unwind_context(CONTEXT& context, DWORD64* pcs, size_t maxCount)
+#endif
+{
+	size_t count = 0;
+	__try
+	{
+#ifdef _WIN64
+		while (count < maxCount && context.Rip)
+		{
+			pcs[count++] = context.Rip;
+			DWORD64 imageBase = 0;
+			PRUNTIME_FUNCTION func = lookup_function(images, context.Rip, imageBase);
+			if (func)
+			{
+				void* handlerData = NULL;
+				DWORD64 establisherFrame = 0;
+				RtlVirtualUnwind(UNW_FLAG_NHANDLER, imageBase, context.Rip, func, &context, &handlerData, &establisherFrame, NULL);
+			}
+			else if (imageBase)
+			{//叶函数，返回地址在栈顶
+				context.Rip = *(DWORD64*)context.Rsp;
+				context.Rsp += 8;
+			}
+			else
+			{//不在已知模块中(动态生成的代码或快照后加载的模块)，无法继续回溯
+				break;
+			}
+		}
+#else
+		if (context.Eip)
+		{
+			pcs[count++] = context.Eip;
+		}
+		DWORD ebp = context.Ebp;
+		while (count < maxCount && ebp)
+		{
+			DWORD nextEbp = ((DWORD*)ebp)[0];
+			DWORD retAddr = ((DWORD*)ebp)[1];
+			if (!retAddr)
+			{
+				break;
+			}
+			pcs[count++] = retAddr;
+			if (nextEbp <= ebp)
+			{//栈向低地址增长，上一帧一定在更高地址
+				break;
+			}
+			ebp = nextEbp;
+		}
+#endif
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{//栈已损坏，保留已取到的部分
+	}
+	return count;
+}
+
+/*!
+@brief 挂起线程取调用栈，恢复线程后再解析符号(解析符号会加锁分配内存，不能在目标线程挂起时进行)；
+模块快照在挂起之前取得，挂起期间只读内存
+*/
+static std::string thread_backtrace(HANDLE hThread)
+{
+	DWORD64 pcs[32];
+	size_t count = 0;
+	CONTEXT context;
+	memset(&context, 0, sizeof(context));
+	context.ContextFlags = CONTEXT_FULL;
+#ifdef _WIN64
+	std::vector<image_pdata> images;
+	snapshot_images(images);
+#endif
+	if ((DWORD)-1 == SuspendThread(hThread))
+	{
+		return std::string();
+	}
+	if (GetThreadContext(hThread, &context))
+	{
+#ifdef _WIN64
+		count = unwind_context(images, context, pcs, sizeof(pcs) / sizeof(pcs[0]));
+#else
+		count = unwind_context(context, pcs, sizeof(pcs) / sizeof(pcs[0]));
+#endif
+	}
+	ResumeThread(hThread);
+	std::string result;
+	char symBuff[sizeof(SYMBOL_INFO) + 256];
+	SYMBOL_INFO* symbol = (SYMBOL_INFO*)symBuff;
+	for (size_t i = 0; i < count; i++)
+	{
+		char line[512];
+		memset(symBuff, 0, sizeof(symBuff));
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = 255;
+		DWORD64 displacement = 0;
+		if (SymFromAddr(GetCurrentProcess(), pcs[i], &displacement, symbol))
+		{
+			sprintf_s(line, "%s+0x%llx\r\n", symbol->Name, (unsigned long long)displacement);
+		}
+		else
+		{
+			sprintf_s(line, "0x%llx\r\n", (unsigned long long)pcs[i]);
+		}
+		result += line;
+	}
+	return result;
+}
+
+ios_proxy::ios_proxy(size_t concurrencyHint)
+: _ios(concurrencyHint)
 {
 	_opend = false;
 	_runLock = NULL;
 	_runCount = 0;
 	_priority = normal;
+	_watchThresholdMs = 0;
+	_watchStop = false;
+	_suspended = false;
+	_watchThread = NULL;
 	_implPool = create_pool<impl_type>(256, [](void* p)
 	{
 		new(p)impl_type();
@@ -41,6 +256,21 @@ void ios_proxy::run(size_t threadNum)
 		_runCount = 0;
 		_runLock = new boost::asio::io_service::work(_ios);
 		_handleList.resize(threadNum);
+		if (_watchThresholdMs > 0)
+		{
+			_watchSlots.resize(threadNum);
+			for (size_t i = 0; i < threadNum; i++)
+			{
+				watch_slot* slot = new watch_slot;
+				slot->_beginCycle = 0;
+				slot->_actorID = 0;
+				slot->_strand = NULL;
+				slot->_reportedCycle = 0;
+				slot->_thread = NULL;
+				slot->_threadID = 0;
+				_watchSlots[i] = slot;
+			}
+		}
 		size_t rc = 0;
 		std::shared_ptr<boost::mutex> blockMutex(new boost::mutex);
 		std::shared_ptr<boost::condition_variable> blockConVar(new boost::condition_variable);
@@ -56,6 +286,12 @@ void ios_proxy::run(size_t threadNum)
 					{
 						SetThreadPriority(GetCurrentThread(), _priority);
 						DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &_handleList[i], 0, FALSE, DUPLICATE_SAME_ACCESS);
+						if (!_watchSlots.empty())
+						{
+							_watchSlots[i]->_thread = _handleList[i];
+							_watchSlots[i]->_threadID = GetCurrentThreadId();
+							_tlsWatchSlot = _watchSlots[i];
+						}
 						auto blockMutex = weakMutex.lock();
 						auto blockConVar = weakConVar.lock();
 						boost::unique_lock<boost::mutex> ul(*blockMutex);
@@ -68,21 +304,25 @@ void ios_proxy::run(size_t threadNum)
 							blockConVar->wait(ul);
 						}
 					}
-					_runCount += _ios.run();
+					RUNTIME_METRIC(_iosThreads.add());
+					size_t handlers = _ios.run();
+					_runCount += handlers;
+					RUNTIME_METRIC(_iosThreads.sub());
+					_tlsWatchSlot = NULL;
 				}
 				catch (msg_data::pool_memory_exception&)
 				{
-					MessageBoxA(NULL, "ڴ治", NULL, NULL);
+					MessageBoxA(NULL, "内存不足", NULL, NULL);
 					exit(1);
 				}
 				catch (boost::exception&)
 				{
-					MessageBoxA(NULL, "δBOOST쳣", NULL, NULL);
+					MessageBoxA(NULL, "未处理的BOOST异常", NULL, NULL);
 					exit(2);
 				}
 				catch (std::exception&)
 				{
-					MessageBoxA(NULL, "δSTD쳣", NULL, NULL);
+					MessageBoxA(NULL, "未处理的STD异常", NULL, NULL);
 					exit(3);
 				}
 				catch (std::shared_ptr<std::string> msg)
@@ -92,7 +332,7 @@ void ios_proxy::run(size_t threadNum)
 				}
 				catch (...)
 				{
-					MessageBoxA(NULL, "δ֪쳣", NULL, NULL);
+					MessageBoxA(NULL, "未知异常", NULL, NULL);
 					exit(-1);
 				}
 			});
@@ -100,6 +340,15 @@ void ios_proxy::run(size_t threadNum)
 			_runThreads.add_thread(newThread);
 		}
 		blockConVar->wait(ul);
+		if (!_watchSlots.empty())
+		{
+			_watchingCount++;
+			_watchStop = false;
+			_watchThread = new boost::thread([this]()
+			{
+				watchdogRun();
+			});
+		}
 	}
 }
 
@@ -112,6 +361,22 @@ void ios_proxy::stop()
 		delete _runLock;
 		_runLock = NULL;
 		_runThreads.join_all();
+		if (_watchThread)
+		{
+			_watchMutex.lock();
+			_watchStop = true;
+			_watchConVar.notify_one();
+			_watchMutex.unlock();
+			_watchThread->join();
+			delete _watchThread;
+			_watchThread = NULL;
+			_watchingCount--;
+		}
+		for (auto it = _watchSlots.begin(); it != _watchSlots.end(); it++)
+		{
+			delete *it;
+		}
+		_watchSlots.clear();
 		_ios.reset();
 		_threadIDs.clear();
 		_ctrlMutex.lock();
@@ -124,6 +389,7 @@ void ios_proxy::stop()
 void ios_proxy::suspend()
 {
 	boost::lock_guard<boost::mutex> lg(_ctrlMutex);
+	_suspended = true;
 	for (auto it = _handleList.begin(); it != _handleList.end(); it++)
 	{
 		SuspendThread(*it);
@@ -137,6 +403,7 @@ void ios_proxy::resume()
 	{
 		ResumeThread(*it);
 	}
+	_suspended = false;
 }
 
 bool ios_proxy::runningInThisIos()
@@ -195,6 +462,109 @@ ios_proxy::operator boost::asio::io_service&() const
 	return (boost::asio::io_service&)_ios;
 }
 
+void ios_proxy::enableWatchdog(int thresholdMs, const std::function<void (const ios_stall_info&)>& h)
+{
+	assert(thresholdMs > 0);
+	boost::lock_guard<boost::mutex> lg(_runMutex);
+	assert(!_opend);
+	_watchThresholdMs = thresholdMs;
+	_watchHandler = h;
+	calibrate_cycle();
+	static boost::once_flag symOnce = BOOST_ONCE_INIT;
+	boost::call_once(symOnce, []()
+	{//进程内只初始化一次符号，之后只在看门狗线程(目标线程已恢复)中解析
+		SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+		SymInitialize(GetCurrentProcess(), NULL, TRUE);
+	});
+}
+
+bool ios_proxy::watchBegin()
+{
+	watch_slot* slot = (watch_slot*)_tlsWatchSlot;
+	if (slot && !slot->_beginCycle.load(boost::memory_order_relaxed))
+	{
+		slot->_beginCycle.store(get_cycle(), boost::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+void ios_proxy::watchEnd()
+{
+	watch_slot* slot = (watch_slot*)_tlsWatchSlot;
+	if (slot)
+	{
+		slot->_beginCycle.store(0, boost::memory_order_relaxed);
+	}
+}
+
+ios_proxy::watch_mark ios_proxy::watchActor(long long actorID, boost_strand* strand)
+{
+	watch_mark mark = { 0, NULL };
+	watch_slot* slot = (watch_slot*)_tlsWatchSlot;
+	if (slot)
+	{
+		mark._actorID = slot->_actorID.exchange(actorID, boost::memory_order_relaxed);
+		mark._strand = slot->_strand.exchange(strand, boost::memory_order_relaxed);
+	}
+	return mark;
+}
+
+void ios_proxy::watchRestore(const watch_mark& mark)
+{
+	watchActor(mark._actorID, mark._strand);
+}
+
+void ios_proxy::watchdogRun()
+{
+	int periodMs = _watchThresholdMs >= 4 ? _watchThresholdMs / 4 : 1;
+	boost::unique_lock<boost::mutex> ul(_watchMutex);
+	while (!_watchStop)
+	{
+		_watchConVar.wait_for(ul, boost::chrono::milliseconds(periodMs));
+		if (_watchStop)
+		{
+			break;
+		}
+		_ctrlMutex.lock();
+		bool suspended = _suspended;
+		_ctrlMutex.unlock();
+		if (suspended)
+		{//整个调度器被挂起，不算阻塞
+			continue;
+		}
+		ul.unlock();
+		unsigned long long nowCycle = get_cycle();
+		for (auto it = _watchSlots.begin(); it != _watchSlots.end(); it++)
+		{
+			watch_slot* slot = *it;
+			unsigned long long beginCycle = slot->_beginCycle.load(boost::memory_order_relaxed);
+			if (!beginCycle || beginCycle >= nowCycle || beginCycle == slot->_reportedCycle)
+			{
+				continue;
+			}
+			int elapsedMs = (int)(cycle_to_us(nowCycle - beginCycle) / 1000);
+			if (elapsedMs < _watchThresholdMs)
+			{
+				continue;
+			}
+			slot->_reportedCycle = beginCycle;
+			RUNTIME_METRIC(_iosStalls.add());
+			ios_stall_info info;
+			info._actorID = slot->_actorID.load(boost::memory_order_relaxed);
+			info._strand = slot->_strand.load(boost::memory_order_relaxed);
+			info._threadID = slot->_threadID;
+			info._elapsedMs = elapsedMs;
+			info._backtrace = thread_backtrace(slot->_thread);
+			if (_watchHandler)
+			{
+				_watchHandler(info);
+			}
+		}
+		ul.lock();
+	}
+}
+
 void* ios_proxy::getImpl()
 {
 	return ((mem_pool_base<impl_type>*)_implPool)->new_();
@@ -207,10 +577,12 @@ void ios_proxy::freeImpl(void* impl)
 
 void* ios_proxy::getTimer()
 {
+	RUNTIME_METRIC(_timerAlive.add());
 	return ((mem_pool_base<timer_type>*)_timerPool)->new_();
 }
 
 void ios_proxy::freeTimer(void* timer)
 {
 	((mem_pool_base<timer_type>*)_timerPool)->delete_(timer);
+	RUNTIME_METRIC(_timerAlive.sub());
 }
\ No newline at end of file
@@ -6,17 +6,52 @@
 #include <boost/thread.hpp>
 #include <set>
 #include <vector>
+#include <string>
+#include <functional>
 
 class strand_ex;
 class my_actor;
+class boost_strand;
 
 /*!
-@brief io_serviceװ
+@brief 看门狗发现的一次长时间运行(阻塞strand)的handler或Actor
+*/
+struct ios_stall_info
+{
+	long long _actorID;///<正在运行的Actor，0表示普通handler
+	boost_strand* _strand;///<该Actor的self_strand，仅用于标识，不要在回调中访问
+	unsigned _threadID;///<被阻塞的调度线程
+	int _elapsedMs;///<发现时已运行的时间
+	std::string _backtrace;///<被阻塞线程的调用栈，获取失败时为空
+};
+
+/*!
+@brief io_service调度器封装
 */
 class ios_proxy
 {
 	friend strand_ex;
 	friend my_actor;
+	friend boost_strand;
+
+	/*!
+	@brief 每个调度线程当前运行的handler，由看门狗线程采样
+	*/
+	struct watch_slot
+	{
+		boost::atomic<unsigned long long> _beginCycle;///<当前handler开始时间，0表示空闲
+		boost::atomic<long long> _actorID;
+		boost::atomic<boost_strand*> _strand;
+		unsigned long long _reportedCycle;///<已报告过的handler开始时间，只由看门狗线程访问
+		HANDLE _thread;
+		unsigned _threadID;
+	};
+
+	struct watch_mark
+	{
+		long long _actorID;
+		boost_strand* _strand;
+	};
 public:
 	enum priority
 	{
@@ -29,74 +64,106 @@ public:
 		time_critical = THREAD_PRIORITY_TIME_CRITICAL
 	};
 public:
-	ios_proxy();
+	/*!
+	@brief 创建调度器
+	@param concurrencyHint 完成端口上允许同时运行的线程数上限，默认不限制；
+	设置为CPU线程数或run()的线程数，可以减少IO完成时多余的线程唤醒和切换
+	*/
+	ios_proxy(size_t concurrencyHint = (size_t)-1);
 	~ios_proxy();
 public:
 	/*!
-	@brief ʼеϺ
-	@param threadNum ߳
+	@brief 开始运行调度器，非阻塞，启动完毕后立即返回
+	@param threadNum 调度器并发线程数
 	*/
 	void run(size_t threadNum = 1);
 
 	/*!
-	@brief ȴʱ
+	@brief 等待调度器中无任务时返回
 	*/
 	void stop();
 
 	/*!
-	@brief ߳
+	@brief 挂起调度器所有线程
 	*/
 	void suspend();
 
 	/*!
-	@brief ָ߳
+	@brief 恢复调度器所有线程
 	*/
 	void resume();
 
 	/*!
-	@brief ⵱ǰǷڱִ
+	@brief 检测当前函数是否在本调度器中执行
 	*/
 	bool runningInThisIos();
 
 	/*!
-	@brief ߳
+	@brief 调度器线程数
 	*/
 	size_t threadNumber();
 
 	/*!
-	@brief ߳ȼ
+	@brief 调度器线程优先级设置
 	*/
 	void runPriority(priority pri);
 
 	/*!
-	@brief ȡǰȼ
+	@brief 获取当前调度器优先级
 	*/
 	priority getPriority();
 
 	/*!
-	@brief ȡδrun()stop()ĵ
+	@brief 获取调度器本次从run()到stop()后的迭代次数
 	*/
 	long long getRunCount();
 
 	/*!
-	@brief ȡCPU
+	@brief 获取CPU核心数
 	*/
 	static unsigned physicalConcurrency();
 
 	/*!
-	@brief ȡCPU߳
+	@brief 获取CPU线程数
 	*/
 	static unsigned hardwareConcurrency();
 
 	/*!
-	@brief CPU
+	@brief 设置CPU关联
 	*/
 	void cpuAffinity(unsigned mask);
 
 	/*!
-	@brief 
+	@brief 调度器对象引用
 	*/
 	operator boost::asio::io_service& () const;
+
+	/*!
+	@brief 启用看门狗，在run()之前调用；一个handler或Actor单次运行超过 thresholdMs 毫秒时，
+	在看门狗线程中回调 h(每次阻塞只报告一次)，启用 runtime_metrics 时同时累计 _iosStalls；
+	只计时经过 boost_strand 的 post/dispatch/wrap/wrap_post 的handler和Actor运行片段，
+	直接交给io_service、不经过strand的完成回调不计时；x86下调用栈依赖帧指针(/Oy-)
+	*/
+	void enableWatchdog(int thresholdMs, const std::function<void (const ios_stall_info&)>& h);
+private:
+	static bool watching()
+	{
+		return 0 != _watchingCount.load(boost::memory_order_relaxed);
+	}
+
+	/*!
+	@brief 标记当前线程开始/结束一个handler，嵌套时只有最外层生效
+	@return 本次是否是最外层
+	*/
+	static bool watchBegin();
+	static void watchEnd();
+
+	/*!
+	@brief 标记当前线程正在运行的Actor，返回之前的标记用于恢复
+	*/
+	static watch_mark watchActor(long long actorID, boost_strand* strand);
+	static void watchRestore(const watch_mark& mark);
+	void watchdogRun();
 private:
 	void* getImpl();
 	void freeImpl(void* impl);
@@ -109,6 +176,15 @@ private:
 	void* _implPool;
 	void* _timerPool;
 	std::vector<HANDLE> _handleList;
+	std::vector<watch_slot*> _watchSlots;
+	int _watchThresholdMs;
+	bool _watchStop;
+	bool _suspended;
+	std::function<void (const ios_stall_info&)> _watchHandler;
+	boost::thread* _watchThread;
+	boost::mutex _watchMutex;
+	boost::condition_variable _watchConVar;
+	static boost::atomic<int> _watchingCount;///<正在运行看门狗的调度器数，都停止后post不再包装
 	boost::atomic<long long> _runCount;
 	boost::mutex _ctrlMutex;
 	boost::mutex _runMutex;
@@ -0,0 +1,156 @@
+#include "metrics_sink.h"
+#include <stdio.h>
+#include <Windows.h>
+
+#define METRICS_HTTP_REQUEST_SIZE	(4 kB)
+#define METRICS_HTTP_TIMEOUT		5000
+
+metrics_file_sink::metrics_file_sink()
+{
+	_intervalMs = 0;
+}
+
+metrics_file_sink::~metrics_file_sink()
+{
+
+}
+
+std::shared_ptr<metrics_file_sink> metrics_file_sink::create(shared_strand strand, const char* fileName, int intervalMs)
+{
+	assert(intervalMs > 0);
+	std::shared_ptr<metrics_file_sink> res(new metrics_file_sink);
+	res->_fileName = fileName;
+	res->_intervalMs = intervalMs;
+	res->_actor = my_actor::create(strand, [res](my_actor* self){res->writeActor(self); });
+	res->_actor->notify_run();
+	return res;
+}
+
+void metrics_file_sink::close()
+{
+	if (_actor)
+	{
+		_actor->notify_quit();
+		_actor.reset();
+	}
+}
+
+bool metrics_file_sink::write_file()
+{
+	std::string text = metrics_registry::export_text();
+	std::string tempName = _fileName + ".tmp";
+	HANDLE file = CreateFileA(tempName.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return false;
+	}
+	DWORD written = 0;
+	BOOL ok = WriteFile(file, text.data(), (DWORD)text.size(), &written, NULL);
+	CloseHandle(file);
+	if (!ok || written != text.size())
+	{
+		return false;
+	}
+	return !!MoveFileExA(tempName.c_str(), _fileName.c_str(), MOVEFILE_REPLACE_EXISTING);
+}
+
+void metrics_file_sink::writeActor(my_actor* self)
+{
+	while (true)
+	{
+		write_file();
+		self->sleep(_intervalMs);
+	}
+}
+//////////////////////////////////////////////////////////////////////////
+
+metrics_http_sink::metrics_http_sink()
+{
+
+}
+
+metrics_http_sink::~metrics_http_sink()
+{
+	close();
+}
+
+std::shared_ptr<metrics_http_sink> metrics_http_sink::create(shared_strand strand, size_t port)
+{
+	std::shared_ptr<metrics_http_sink> res(new metrics_http_sink);
+	res->_acceptor = acceptor_socket::create(strand, port, [strand](socket_handle socket)
+	{
+		my_actor::create(strand, [socket](my_actor* self){session(self, socket); })->notify_run();
+	});
+	if (!res->_acceptor)
+	{
+		return std::shared_ptr<metrics_http_sink>();
+	}
+	return res;
+}
+
+void metrics_http_sink::close()
+{
+	if (_acceptor)
+	{
+		_acceptor->close();
+		_acceptor.reset();
+	}
+}
+
+void metrics_http_sink::session(my_actor* self, socket_handle socket)
+{
+	//读到请求头结尾"\r\n\r\n"为止，请求内容不解析
+	char request[METRICS_HTTP_REQUEST_SIZE + 1];
+	size_t length = 0;
+	while (true)
+	{
+		actor_trig_handle<boost::system::error_code, size_t> ath;
+		socket->async_read_some((unsigned char*)request + length, METRICS_HTTP_REQUEST_SIZE - length, self->make_trig_notifer(ath));
+		boost::system::error_code ec;
+		size_t n = 0;
+		if (!self->timed_wait_trig(METRICS_HTTP_TIMEOUT, ath, ec, n))
+		{
+			socket->close();
+			self->wait_trig(ath, ec, n);
+			return;
+		}
+		if (ec)
+		{
+			socket->close();
+			return;
+		}
+		length += n;
+		request[length] = 0;
+		if (strstr(request, "\r\n\r\n"))
+		{
+			break;
+		}
+		if (METRICS_HTTP_REQUEST_SIZE == length)
+		{
+			socket->close();
+			return;
+		}
+	}
+	std::string body;
+	std::string status;
+	if (0 == strncmp(request, "GET ", 4))
+	{
+		body = metrics_registry::export_text();
+		status = "200 OK";
+	}
+	else
+	{
+		status = "405 Method Not Allowed";
+	}
+	char head[256];
+	sprintf_s(head, "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %d\r\nConnection: close\r\n\r\n", status.c_str(), (int)body.size());
+	std::vector<boost::asio::const_buffer> buffs;
+	buffs.push_back(boost::asio::const_buffer(head, strlen(head)));
+	buffs.push_back(boost::asio::const_buffer(body.data(), body.size()));
+	actor_trig_handle<boost::system::error_code, size_t> ath;
+	socket->async_write(buffs, self->make_trig_notifer(ath));
+	boost::system::error_code ec;
+	size_t n = 0;
+	self->wait_trig(ath, ec, n);
+	socket->close();
+}
@@ -0,0 +1,57 @@
+#ifndef __METRICS_SINK_H
+#define __METRICS_SINK_H
+
+#include "actor_framework.h"
+#include "acceptor_socket.h"
+#include <string>
+
+/*!
+@brief 指标导出目标，导出内容为 metrics_registry::export_text()
+*/
+class metrics_sink
+{
+public:
+	virtual ~metrics_sink() {}
+	virtual void close() = 0;
+};
+
+/*!
+@brief 定时把指标写到文件(先写临时文件再替换，读取方不会读到半个文件)
+*/
+class metrics_file_sink : public metrics_sink
+{
+private:
+	metrics_file_sink();
+public:
+	~metrics_file_sink();
+	static std::shared_ptr<metrics_file_sink> create(shared_strand strand, const char* fileName, int intervalMs = 10000);
+public:
+	void close();
+private:
+	void writeActor(my_actor* self);
+	bool write_file();
+private:
+	std::string _fileName;
+	int _intervalMs;
+	actor_handle _actor;
+};
+
+/*!
+@brief 极简HTTP端点，任何GET请求都返回Prometheus文本格式的指标，每个连接由一个Actor服务，应答后关闭
+*/
+class metrics_http_sink : public metrics_sink
+{
+private:
+	metrics_http_sink();
+public:
+	~metrics_http_sink();
+	static std::shared_ptr<metrics_http_sink> create(shared_strand strand, size_t port);
+public:
+	void close();
+private:
+	static void session(my_actor* self, socket_handle socket);
+private:
+	accept_handle _acceptor;
+};
+
+#endif
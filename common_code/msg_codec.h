@@ -0,0 +1,415 @@
+#ifndef __MSG_CODEC_H
+#define __MSG_CODEC_H
+
+#include "shared_data.h"
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <type_traits>
+#include <string>
+#include <vector>
+#include <string.h>
+
+/*!
+@brief 消息参数编解码，按类型在编译期选择实现：
+POD直接内存拷贝；整数在 VarInt 打开时用zigzag变长编码；
+std::string/std::vector/shared_data为变长长度+数据；自定义结构用 MSG_CODEC_REFLECT 声明字段；
+decode 数据不足或格式错误时返回NULL
+*/
+template <typename T>
+struct codec_traits;
+
+struct codec_varint
+{
+	static size_t size(unsigned long long v)
+	{
+		size_t s = 1;
+		while (v >= 0x80)
+		{
+			v >>= 7;
+			s++;
+		}
+		return s;
+	}
+
+	static char* encode(char* p, unsigned long long v)
+	{
+		while (v >= 0x80)
+		{
+			*p++ = (char)(v | 0x80);
+			v >>= 7;
+		}
+		*p++ = (char)v;
+		return p;
+	}
+
+	static const char* decode(const char* p, const char* end, unsigned long long& v)
+	{
+		v = 0;
+		for (size_t shift = 0; p != end && shift < 64; shift += 7)
+		{
+			unsigned char c = (unsigned char)*p++;
+			v |= (unsigned long long)(c & 0x7F) << shift;
+			if (!(c & 0x80))
+			{
+				return p;
+			}
+		}
+		return NULL;
+	}
+
+	template <typename T>
+	static unsigned long long zigzag(T v, typename std::enable_if<std::is_signed<T>::value>::type* = 0)
+	{
+		return ((unsigned long long)(long long)v << 1) ^ (unsigned long long)((long long)v >> 63);
+	}
+
+	template <typename T>
+	static unsigned long long zigzag(T v, typename std::enable_if<!std::is_signed<T>::value>::type* = 0)
+	{
+		return (unsigned long long)v;
+	}
+
+	template <typename T>
+	static T unzigzag(unsigned long long v, typename std::enable_if<std::is_signed<T>::value>::type* = 0)
+	{
+		return (T)(long long)((v >> 1) ^ (0 - (v & 1)));
+	}
+
+	template <typename T>
+	static T unzigzag(unsigned long long v, typename std::enable_if<!std::is_signed<T>::value>::type* = 0)
+	{
+		return (T)v;
+	}
+};
+
+/*!
+@brief POD类型，内存拷贝
+*/
+template <typename T, bool Integral = std::is_integral<T>::value && (sizeof(T) > 1)>
+struct pod_codec_traits
+{
+	template <bool VarInt>
+	static size_t size(const T&)
+	{
+		return sizeof(T);
+	}
+
+	template <bool VarInt>
+	static char* encode(char* p, const T& v)
+	{
+		memcpy(p, &v, sizeof(T));
+		return p + sizeof(T);
+	}
+
+	template <bool VarInt>
+	static const char* decode(const char* p, const char* end, T& v)
+	{
+		if ((size_t)(end - p) < sizeof(T))
+		{
+			return NULL;
+		}
+		memcpy(&v, p, sizeof(T));
+		return p + sizeof(T);
+	}
+};
+
+/*!
+@brief 多字节整数，VarInt时变长编码
+*/
+template <typename T>
+struct pod_codec_traits<T, true>
+{
+	template <bool VarInt>
+	static size_t size(const T& v)
+	{
+		return VarInt ? codec_varint::size(codec_varint::zigzag(v)) : sizeof(T);
+	}
+
+	template <bool VarInt>
+	static char* encode(char* p, const T& v)
+	{
+		if (VarInt)
+		{
+			return codec_varint::encode(p, codec_varint::zigzag(v));
+		}
+		memcpy(p, &v, sizeof(T));
+		return p + sizeof(T);
+	}
+
+	template <bool VarInt>
+	static const char* decode(const char* p, const char* end, T& v)
+	{
+		if (VarInt)
+		{
+			unsigned long long t;
+			p = codec_varint::decode(p, end, t);
+			v = codec_varint::unzigzag<T>(t);
+			return p;
+		}
+		return pod_codec_traits<T, false>::template decode<false>(p, end, v);
+	}
+};
+
+template <typename T>
+struct codec_traits: public pod_codec_traits<T>
+{
+	static_assert(std::is_pod<T>::value, "codec_traits: non-POD types need a specialization or MSG_CODEC_REFLECT");
+};
+
+template <>
+struct codec_traits<std::string>
+{
+	template <bool VarInt>
+	static size_t size(const std::string& v)
+	{
+		return codec_varint::size(v.size()) + v.size();
+	}
+
+	template <bool VarInt>
+	static char* encode(char* p, const std::string& v)
+	{
+		p = codec_varint::encode(p, v.size());
+		memcpy(p, v.data(), v.size());
+		return p + v.size();
+	}
+
+	template <bool VarInt>
+	static const char* decode(const char* p, const char* end, std::string& v)
+	{
+		unsigned long long s;
+		if (!(p = codec_varint::decode(p, end, s)) || (unsigned long long)(end - p) < s)
+		{
+			return NULL;
+		}
+		v.assign(p, (size_t)s);
+		return p + (size_t)s;
+	}
+};
+
+/*!
+@brief 空消息包编码为长度0，其它为长度+1
+*/
+template <>
+struct codec_traits<shared_data>
+{
+	template <bool VarInt>
+	static size_t size(const shared_data& v)
+	{
+		return v ? codec_varint::size(v->size() + 1) + v->size() : 1;
+	}
+
+	template <bool VarInt>
+	static char* encode(char* p, const shared_data& v)
+	{
+		if (!v)
+		{
+			return codec_varint::encode(p, 0);
+		}
+		p = codec_varint::encode(p, v->size() + 1);
+		memcpy(p, v->data(), v->size());
+		return p + v->size();
+	}
+
+	template <bool VarInt>
+	static const char* decode(const char* p, const char* end, shared_data& v)
+	{
+		unsigned long long s;
+		if (!(p = codec_varint::decode(p, end, s)) || (s && (unsigned long long)(end - p) < s - 1))
+		{
+			return NULL;
+		}
+		if (!s)
+		{
+			v.reset();
+			return p;
+		}
+		v = msg_data::create(p, (size_t)(s - 1));
+		return p + (size_t)(s - 1);
+	}
+};
+
+/*!
+@brief std::vector，元素为POD且不需要变长编码(非整数，或没有启用VarInt)时整块拷贝
+*/
+template <typename T, bool VarInt, bool Block = std::is_pod<T>::value && !(VarInt && std::is_integral<T>::value && (sizeof(T) > 1))>
+struct vector_codec_traits
+{
+	static size_t size(const std::vector<T>& v)
+	{
+		size_t s = codec_varint::size(v.size());
+		for (auto it = v.begin(); it != v.end(); it++)
+		{
+			s += codec_traits<T>::template size<VarInt>(*it);
+		}
+		return s;
+	}
+
+	static char* encode(char* p, const std::vector<T>& v)
+	{
+		p = codec_varint::encode(p, v.size());
+		for (auto it = v.begin(); it != v.end(); it++)
+		{
+			p = codec_traits<T>::template encode<VarInt>(p, *it);
+		}
+		return p;
+	}
+
+	static const char* decode(const char* p, const char* end, std::vector<T>& v)
+	{
+		unsigned long long s;
+		if (!(p = codec_varint::decode(p, end, s)) || (unsigned long long)(end - p) < s)
+		{//每个元素至少1字节
+			return NULL;
+		}
+		v.resize((size_t)s);
+		for (auto it = v.begin(); it != v.end(); it++)
+		{
+			if (!(p = codec_traits<T>::template decode<VarInt>(p, end, *it)))
+			{
+				return NULL;
+			}
+		}
+		return p;
+	}
+};
+
+template <typename T, bool VarInt>
+struct vector_codec_traits<T, VarInt, true>
+{
+	static size_t size(const std::vector<T>& v)
+	{
+		return codec_varint::size(v.size()) + v.size() * sizeof(T);
+	}
+
+	static char* encode(char* p, const std::vector<T>& v)
+	{
+		p = codec_varint::encode(p, v.size());
+		if (!v.empty())
+		{
+			memcpy(p, &v[0], v.size() * sizeof(T));
+		}
+		return p + v.size() * sizeof(T);
+	}
+
+	static const char* decode(const char* p, const char* end, std::vector<T>& v)
+	{
+		unsigned long long s;
+		if (!(p = codec_varint::decode(p, end, s)) || (unsigned long long)(end - p) / sizeof(T) < s)
+		{
+			return NULL;
+		}
+		v.resize((size_t)s);
+		if (s)
+		{
+			memcpy(&v[0], p, (size_t)s * sizeof(T));
+		}
+		return p + (size_t)s * sizeof(T);
+	}
+};
+
+template <typename T>
+struct codec_traits<std::vector<T> >
+{
+	template <bool VarInt>
+	static size_t size(const std::vector<T>& v)
+	{
+		return vector_codec_traits<T, VarInt>::size(v);
+	}
+
+	template <bool VarInt>
+	static char* encode(char* p, const std::vector<T>& v)
+	{
+		return vector_codec_traits<T, VarInt>::encode(p, v);
+	}
+
+	template <bool VarInt>
+	static const char* decode(const char* p, const char* end, std::vector<T>& v)
+	{
+		return vector_codec_traits<T, VarInt>::decode(p, end, v);
+	}
+};
+
+#define _MSG_CODEC_FIELD_SIZE(__r__, __v__, __field__) + codec_traits<decltype(__v__.__field__)>::template size<VarInt>(__v__.__field__)
+#define _MSG_CODEC_FIELD_ENCODE(__r__, __v__, __field__) p = codec_traits<decltype(__v__.__field__)>::template encode<VarInt>(p, __v__.__field__);
+#define _MSG_CODEC_FIELD_DECODE(__r__, __v__, __field__) if (!(p = codec_traits<decltype(__v__.__field__)>::template decode<VarInt>(p, end, __v__.__field__))) return NULL;
+
+/*!
+@brief 为自定义结构生成编解码，在全局命名空间中使用，字段写成 (a)(b)(c)
+*/
+#define MSG_CODEC_REFLECT(__type__, __fields__) \
+template <>\
+struct codec_traits<__type__>\
+{\
+	template <bool VarInt>\
+	static size_t size(const __type__& v)\
+	{\
+		return 0 BOOST_PP_SEQ_FOR_EACH(_MSG_CODEC_FIELD_SIZE, v, __fields__);\
+	}\
+	template <bool VarInt>\
+	static char* encode(char* p, const __type__& v)\
+	{\
+		BOOST_PP_SEQ_FOR_EACH(_MSG_CODEC_FIELD_ENCODE, v, __fields__)\
+		return p;\
+	}\
+	template <bool VarInt>\
+	static const char* decode(const char* p, const char* end, __type__& v)\
+	{\
+		BOOST_PP_SEQ_FOR_EACH(_MSG_CODEC_FIELD_DECODE, v, __fields__)\
+		return p;\
+	}\
+};
+
+/*!
+@brief 编解码器，可作为remote_node的Codec参数
+@param VarInt 多字节整数是否变长编码
+*/
+template <bool VarInt = false>
+struct msg_codec
+{
+	template <typename T>
+	static size_t size(const T& v)
+	{
+		return codec_traits<T>::template size<VarInt>(v);
+	}
+
+	template <typename T>
+	static char* encode(char* p, const T& v)
+	{
+		return codec_traits<T>::template encode<VarInt>(p, v);
+	}
+
+	template <typename T>
+	static const char* decode(const char* p, const char* end, T& v)
+	{
+		return codec_traits<T>::template decode<VarInt>(p, end, v);
+	}
+
+	/*!
+	@brief 编码一个值到新的消息包
+	*/
+	template <typename T>
+	static shared_data pack(const T& v)
+	{
+		shared_data msg = msg_data::create(size(v));
+		encode(msg->c_str(), v);
+		return msg;
+	}
+
+	/*!
+	@brief 从消息包解码一个值，数据必须恰好用完，空包返回false
+	*/
+	template <typename T>
+	static bool unpack(const shared_data& msg, T& v)
+	{
+		if (!msg || !msg->size())
+		{//任何类型编码后至少1字节
+			return false;
+		}
+		const char* end = msg->c_str() + msg->size();
+		const char* p = decode(msg->c_str(), end, v);
+		return p && p == end;
+	}
+};
+
+typedef msg_codec<true> varint_codec;
+
+#endif
@@ -7,7 +7,7 @@
 #include <boost/thread/shared_mutex.hpp>
 
 /*!
-@brief ActorͨŹܵ
+@brief Actor间通信管道
 */
 template <typename T0 = void, typename T1 = void, typename T2 = void, typename T3 = void>
 class msg_pipe
@@ -296,9 +296,9 @@ private:
 	}
 public:
 	/*!
-	@brief һActorϢܵ
-	@param writer дܵ
-	@return עȡݵĺ
+	@brief 创建一个Actor消息管道
+	@param writer 返回写管道函数
+	@return 返回注册读取数据的函数
 	*/
 	static regist_reader make(__out writer_type& writer)
 	{
@@ -328,7 +328,7 @@ public:
 	}
 
 	/*!
-	@brief һio
+	@brief 创建一个io
 	*/
 	static io make_io()
 	{
@@ -338,9 +338,9 @@ public:
 	}
 	
 	/*!
-	@brief ActorڴһϢܵ
-	@param getWriterFunc ػȡдܵĺֻڵregist_readerغܴӸúеõ
-	@return עȡݵĺֻעһ
+	@brief Actor内创建一个消息管道
+	@param getWriterFunc 返回获取写管道的函数，只有在调用regist_reader返回后才能从该函数中得到结果
+	@return 返回注册读取数据的函数，只能注册一次
 	*/
 	static regist_reader make(__out get_writer& getWriterFunc)
 	{
@@ -392,7 +392,7 @@ public:
 	}
 	
 	/*!
-	@brief ͬϣget_writer_outside ֻ regist_reader ͬĵڻȡ writer_type
+	@brief 同上，get_writer_outside 只能在与调用 regist_reader 不同的调度器内获取 writer_type
 	*/
 	static regist_reader make(__out get_writer_outside& getWriterFunc)
 	{
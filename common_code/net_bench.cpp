@@ -0,0 +1,285 @@
+#include "net_bench.h"
+#include "text_stream_io.h"
+#include "scattered.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NET_BENCH_STAMP_SIZE	16
+
+struct net_conn_stats
+{
+	net_conn_stats()
+	:_sent(0), _received(0), _error(false) {}
+
+	long long _sent;
+	long long _received;
+	bool _error;
+	std::vector<int> _latencyUs;
+};
+
+static void percentiles(std::vector<int>& v, char* buf, size_t size)
+{
+	if (v.empty())
+	{
+		sprintf_s(buf, size, "{\"p50\": 0, \"p90\": 0, \"p99\": 0, \"p999\": 0, \"max\": 0}");
+		return;
+	}
+	std::sort(v.begin(), v.end());
+	size_t n = v.size() - 1;
+	sprintf_s(buf, size, "{\"p50\": %d, \"p90\": %d, \"p99\": %d, \"p999\": %d, \"max\": %d}",
+		v[n * 50 / 100], v[n * 90 / 100], v[n * 99 / 100], v[n * 999 / 1000], v.back());
+}
+
+net_bench_options::net_bench_options()
+:_ip("127.0.0.1"), _port(9000), _connections(64), _msgSize(64), _rate(0), _window(1), _durationMs(10000)
+{
+
+}
+
+net_bench::net_bench(ios_proxy& ios)
+:_ios(ios)
+{
+	_strands.resize(ios.threadNumber() ? ios.threadNumber() : 1);
+	for (size_t i = 0; i < _strands.size(); i++)
+	{
+		_strands[i] = boost_strand::create(ios);
+	}
+}
+
+net_bench::~net_bench()
+{
+	stop_server();
+}
+
+bool net_bench::start_echo(size_t port)
+{
+	return start_relay(port, NULL, 0);
+}
+
+bool net_bench::start_relay(size_t port, const char* upstreamIp, size_t upstreamPort)
+{
+	assert(!_acceptor);
+	std::string upIp = upstreamIp ? upstreamIp : "";
+	_acceptor = acceptor_socket::create(_strands, port, [upIp, upstreamPort](shared_strand strand, socket_handle socket)
+	{
+		if (socket)
+		{
+			socket->no_delay();
+			my_actor::create(strand, [socket, upIp, upstreamPort](my_actor* self)
+			{
+				session(self, socket, upIp, upstreamPort);
+			})->notify_run();
+		}
+	});
+	return !!_acceptor;
+}
+
+void net_bench::stop_server()
+{
+	if (_acceptor)
+	{
+		_acceptor->close();
+		_acceptor.reset();
+	}
+}
+
+void net_bench::session(my_actor* self, socket_handle down, const std::string& upIp, size_t upPort)
+{
+	//side 0为客户端来的行，1为上游回来的行
+	actor_msg_handle<shared_lines, int> amh;
+	std::shared_ptr<text_stream_io> upIo;
+	if (!upIp.empty())
+	{
+		socket_handle up = socket_io::create(self->self_strand()->get_io_service());
+		actor_trig_handle<boost::system::error_code> ath;
+		up->async_connect(upIp.c_str(), upPort, self->make_trig_notifer(ath));
+		if (self->wait_trig(ath))
+		{
+			up->close();
+			down->close();
+			return;
+		}
+		up->no_delay();
+		auto h = self->make_msg_notifer(amh);
+		upIo = text_stream_io::create_batch(self->self_strand(), up, [h](shared_lines lines){h(lines, 1); });
+	}
+	auto h = self->make_msg_notifer(amh);
+	std::shared_ptr<text_stream_io> downIo = text_stream_io::create_batch(self->self_strand(), down, [h](shared_lines lines){h(lines, 0); });
+	while (true)
+	{
+		shared_lines lines;
+		int side = 0;
+		self->wait_msg(amh, lines, side);
+		if (!lines)
+		{
+			break;
+		}
+		text_stream_io* dst = (0 == side && upIo) ? upIo.get() : downIo.get();
+		for (size_t i = 0; i < lines->size(); i++)
+		{
+			dst->write(msg_data::create(lines->line(i), lines->length(i)));
+		}
+	}
+	self->close_msg_notifer(amh);
+	downIo->close();
+	if (upIo)
+	{
+		upIo->close();
+	}
+}
+
+std::string net_bench::run_load(my_actor* self, const net_bench_options& opt)
+{
+	assert(opt._connections > 0 && opt._msgSize >= NET_BENCH_STAMP_SIZE && opt._msgSize < 64 kB && opt._window > 0);
+	//建连阶段：同时发起所有连接
+	std::vector<socket_handle> sockets(opt._connections);
+	std::vector<int> connectUs;
+	actor_msg_handle<size_t, boost::system::error_code, long long> cmh;
+	auto connectNotify = self->make_msg_notifer(cmh);
+	long long connectBegin = get_tick_us();
+	for (int i = 0; i < opt._connections; i++)
+	{
+		sockets[i] = socket_io::create(_strands[i % _strands.size()]->get_io_service());
+		size_t id = i;
+		long long tk = get_tick_us();
+		sockets[i]->async_connect(opt._ip.c_str(), opt._port, [connectNotify, id, tk](const boost::system::error_code& ec)
+		{
+			connectNotify(id, ec, get_tick_us() - tk);
+		});
+	}
+	for (int i = 0; i < opt._connections; i++)
+	{
+		size_t id = 0;
+		boost::system::error_code ec;
+		long long dt = 0;
+		self->wait_msg(cmh, id, ec, dt);
+		if (ec)
+		{
+			sockets[id]->close();
+			sockets[id].reset();
+		}
+		else
+		{
+			sockets[id]->no_delay();
+			connectUs.push_back((int)dt);
+		}
+	}
+	long long connectTotalUs = get_tick_us() - connectBegin;
+	self->close_msg_notifer(cmh);
+
+	//压测阶段：每个连接一个Actor，按速率或窗口发送，收到回应后计算往返延迟
+	std::vector<net_conn_stats> stats(opt._connections);
+	list<child_actor_handle::ptr> childList;
+	long long loadBegin = get_tick_us();
+	long long loadEnd = loadBegin + (long long)opt._durationMs * 1000;
+	for (int i = 0; i < opt._connections; i++)
+	{
+		if (!sockets[i])
+		{
+			continue;
+		}
+		socket_handle socket = sockets[i];
+		net_conn_stats* st = &stats[i];
+		auto newActor = child_actor_handle::make_ptr();
+		*newActor = self->create_child_actor(_strands[i % _strands.size()], [socket, st, &opt, loadEnd](my_actor* self)
+		{
+			actor_msg_handle<shared_lines> amh;
+			auto textio = text_stream_io::create_batch(self->self_strand(), socket, self->make_msg_notifer(amh));
+			long long interval = opt._rate > 0 ? 1000000 / opt._rate : 0;
+			long long nextSend = get_tick_us();
+			int inFlight = 0;
+			bool closed = false;
+			while (!closed)
+			{
+				long long now = get_tick_us();
+				if (now >= loadEnd)
+				{
+					break;
+				}
+				if (inFlight < opt._window && (!interval || now >= nextSend))
+				{
+					shared_data msg = msg_data::create(opt._msgSize);
+					char stamp[NET_BENCH_STAMP_SIZE + 1];
+					sprintf_s(stamp, "%016llx", now);
+					memcpy(msg->data(), stamp, NET_BENCH_STAMP_SIZE);
+					memset((char*)msg->data() + NET_BENCH_STAMP_SIZE, 'x', opt._msgSize - NET_BENCH_STAMP_SIZE);
+					textio->write(msg);
+					st->_sent++;
+					inFlight++;
+					nextSend += interval;
+					if (nextSend < now - 1000000)
+					{//落后超过1秒不再追赶
+						nextSend = now;
+					}
+					continue;
+				}
+				long long waitUs = loadEnd - now;
+				if (interval && inFlight < opt._window && nextSend - now < waitUs)
+				{
+					waitUs = nextSend - now;
+				}
+				shared_lines lines;
+				if (!self->timed_wait_msg((int)(waitUs / 1000), amh, lines))
+				{
+					continue;
+				}
+				if (!lines)
+				{
+					st->_error = true;
+					closed = true;
+					break;
+				}
+				long long recvTick = get_tick_us();
+				for (size_t j = 0; j < lines->size(); j++)
+				{
+					if (lines->length(j) >= NET_BENCH_STAMP_SIZE)
+					{
+						char stamp[NET_BENCH_STAMP_SIZE + 1];
+						memcpy(stamp, lines->line(j), NET_BENCH_STAMP_SIZE);
+						stamp[NET_BENCH_STAMP_SIZE] = 0;
+						st->_latencyUs.push_back((int)(recvTick - (long long)_strtoui64(stamp, NULL, 16)));
+					}
+					st->_received++;
+					inFlight--;
+				}
+			}
+			textio->close();
+			if (!closed)
+			{
+				shared_lines lines;
+				while (self->timed_wait_msg(1000, amh, lines) && lines) {}
+			}
+			self->close_msg_notifer(amh);
+		}, 64 kB);
+		childList.push_back(newActor);
+	}
+	self->child_actor_run(childList);
+	self->child_actors_wait_quit(childList);
+	long long loadUs = get_tick_us() - loadBegin;
+
+	long long sent = 0;
+	long long received = 0;
+	int errors = 0;
+	std::vector<int> latencyUs;
+	for (int i = 0; i < opt._connections; i++)
+	{
+		sent += stats[i]._sent;
+		received += stats[i]._received;
+		errors += stats[i]._error ? 1 : 0;
+		latencyUs.insert(latencyUs.end(), stats[i]._latencyUs.begin(), stats[i]._latencyUs.end());
+	}
+	char connectPct[256];
+	char latencyPct[256];
+	percentiles(connectUs, connectPct, sizeof(connectPct));
+	percentiles(latencyUs, latencyPct, sizeof(latencyPct));
+	double seconds = loadUs > 0 ? (double)loadUs / 1000000 : 1;
+	char buf[2048];
+	sprintf_s(buf, "{\n\t\"connections\": %d,\n\t\"connected\": %d,\n\t\"errors\": %d,\n\t\"msg_size\": %d,\n\t\"rate\": %d,\n\t\"window\": %d,\n\t\"duration_ms\": %d,\n"
+		"\t\"connect_per_sec\": %.1f,\n\t\"connect_us\": %s,\n"
+		"\t\"sent\": %lld,\n\t\"received\": %lld,\n\t\"msgs_per_sec\": %.1f,\n\t\"mb_per_sec\": %.3f,\n\t\"latency_us\": %s\n}\n",
+		opt._connections, (int)connectUs.size(), errors, (int)opt._msgSize, opt._rate, opt._window, opt._durationMs,
+		connectTotalUs > 0 ? (double)connectUs.size() * 1000000 / connectTotalUs : 0, connectPct,
+		sent, received, received / seconds, (double)received * (opt._msgSize + 2) / seconds / (1024 * 1024), latencyPct);
+	return buf;
+}
@@ -0,0 +1,60 @@
+#ifndef __NET_BENCH_H
+#define __NET_BENCH_H
+
+#include "actor_framework.h"
+#include "acceptor_socket.h"
+#include "ios_proxy.h"
+#include <string>
+
+/*!
+@brief 负载测试参数
+*/
+struct net_bench_options
+{
+	net_bench_options();
+
+	std::string _ip;
+	size_t _port;
+	int _connections;///<连接数
+	size_t _msgSize;///<每行消息长度(不含"\r\n")，至少16字节，前16字节为发送时间戳
+	int _rate;///<每个连接每秒发送的消息数，0表示按 _window 闭环尽快发送
+	int _window;///<每个连接最多未收到回应的消息数
+	int _durationMs;///<压测时长
+};
+
+/*!
+@brief 回环TCP负载测试，基于 acceptor_socket/socket_io/text_stream_io，
+提供回显/转发服务端和负载发生器，结果以JSON输出
+*/
+class net_bench
+{
+public:
+	net_bench(ios_proxy& ios);
+	~net_bench();
+public:
+	/*!
+	@brief 每个调度strand各挂一个accept分片监听，收到的每行原样回写
+	*/
+	bool start_echo(size_t port);
+
+	/*!
+	@brief 每个连接再连到上游，双向逐行转发
+	*/
+	bool start_relay(size_t port, const char* upstreamIp, size_t upstreamPort);
+	void stop_server();
+
+	/*!
+	@brief 建立 opt._connections 个连接并压测 opt._durationMs，
+	统计建连速率、吞吐量和往返延迟分位数
+	@return JSON报告
+	*/
+	std::string run_load(my_actor* self, const net_bench_options& opt);
+private:
+	static void session(my_actor* self, socket_handle down, const std::string& upIp, size_t upPort);
+private:
+	ios_proxy& _ios;
+	std::vector<shared_strand> _strands;
+	accept_handle _acceptor;
+};
+
+#endif
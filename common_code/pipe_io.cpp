@@ -0,0 +1,185 @@
+#include "pipe_io.h"
+#include <boost/asio/windows/overlapped_ptr.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/atomic/atomic.hpp>
+#include <stdio.h>
+
+#define PIPE_BUFF_SIZE	(64*1024)
+
+pipe_io::pipe_io( boost::asio::io_service& ios )
+	: stream_io_base(ios), _pipe(ios)
+{
+
+}
+
+pipe_io::~pipe_io()
+{
+	close();
+}
+
+pipe_handle pipe_io::create( boost::asio::io_service& ios )
+{
+	return pipe_handle(new pipe_io(ios));
+}
+
+std::string pipe_io::pipe_name( const char* name )
+{
+	return std::string("\\\\.\\pipe\\") + name;
+}
+
+HANDLE pipe_io::create_server( const std::string& fullName, bool exclusive )
+{
+	DWORD pipeMode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT;
+#ifdef PIPE_REJECT_REMOTE_CLIENTS
+	pipeMode |= PIPE_REJECT_REMOTE_CLIENTS;
+#endif
+	DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED;
+	if (exclusive)
+	{//管道名已被(其它进程)创建时失败，并且不允许再创建第二个实例
+		openMode |= FILE_FLAG_FIRST_PIPE_INSTANCE;
+	}
+	return CreateNamedPipeA(fullName.c_str(), openMode, pipeMode,
+		exclusive ? 1 : PIPE_UNLIMITED_INSTANCES, PIPE_BUFF_SIZE, PIPE_BUFF_SIZE, 0, NULL);
+}
+
+bool pipe_io::create_pair( boost::asio::io_service& ios, pipe_handle& first, pipe_handle& second )
+{
+	static boost::atomic<unsigned> pairID(0);
+	char name[64];
+	sprintf_s(name, "actor_pipe_pair_%u_%u", (unsigned)GetCurrentProcessId(), (unsigned)++pairID);
+	std::string fullName = pipe_name(name);
+	//名字可以被猜到，必须是这个名字的唯一实例，否则客户端可能连到别人预先创建的管道上
+	HANDLE server = create_server(fullName, true);
+	if (INVALID_HANDLE_VALUE == server)
+	{
+		return false;
+	}
+	HANDLE client = CreateFileA(fullName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (INVALID_HANDLE_VALUE == client)
+	{
+		CloseHandle(server);
+		return false;
+	}
+	//客户端已经连上，ConnectNamedPipe直接返回ERROR_PIPE_CONNECTED，不会产生完成通知
+	OVERLAPPED overlapped = {0};
+	if (!ConnectNamedPipe(server, &overlapped) && ERROR_PIPE_CONNECTED != GetLastError())
+	{
+		CloseHandle(client);
+		CloseHandle(server);
+		return false;
+	}
+	first = create(ios);
+	second = create(ios);
+	boost::system::error_code ec1, ec2;
+	first->_pipe.assign(server, ec1);
+	second->_pipe.assign(client, ec2);
+	if (ec1 || ec2)
+	{
+		if (ec1)
+		{
+			CloseHandle(server);
+		}
+		if (ec2)
+		{
+			CloseHandle(client);
+		}
+		first.reset();
+		second.reset();
+		return false;
+	}
+	return true;
+}
+
+void pipe_io::async_accept( const char* name, const std::function<void (const boost::system::error_code&)>& h )
+{
+	boost::system::error_code ec;
+	HANDLE server = create_server(pipe_name(name));
+	if (INVALID_HANDLE_VALUE != server)
+	{
+		_pipe.assign(server, ec);
+		if (ec)
+		{
+			CloseHandle(server);
+		}
+	}
+	else
+	{
+		ec = boost::system::error_code(GetLastError(), boost::system::system_category());
+	}
+	if (ec)
+	{
+		_pipe.get_io_service().post([h, ec](){h(ec); });
+		return;
+	}
+	boost::asio::windows::overlapped_ptr overlapped(_pipe.get_io_service(), [h](const boost::system::error_code& err, size_t)
+	{
+		h(err);
+	});
+	BOOL ok = ConnectNamedPipe(_pipe.native_handle(), overlapped.get());
+	DWORD lastError = GetLastError();
+	if (!ok && ERROR_IO_PENDING != lastError)
+	{
+		if (ERROR_PIPE_CONNECTED == lastError)
+		{
+			overlapped.complete(boost::system::error_code(), 0);
+		}
+		else
+		{
+			overlapped.complete(boost::system::error_code(lastError, boost::system::system_category()), 0);
+		}
+	}
+	else
+	{
+		overlapped.release();
+	}
+}
+
+bool pipe_io::connect( const char* name )
+{
+	std::string fullName = pipe_name(name);
+	HANDLE client = CreateFileA(fullName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (INVALID_HANDLE_VALUE == client)
+	{
+		return false;
+	}
+	boost::system::error_code ec;
+	_pipe.assign(client, ec);
+	if (ec)
+	{
+		CloseHandle(client);
+		return false;
+	}
+	return true;
+}
+
+void pipe_io::close()
+{
+	boost::system::error_code ec;
+	_pipe.close(ec);
+}
+
+void pipe_io::async_write( const unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	boost::asio::async_write(_pipe, boost::asio::buffer(buff, length), h);
+}
+
+void pipe_io::async_write( const std::vector<boost::asio::const_buffer>& buffs, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	boost::asio::async_write(_pipe, buffs, h);
+}
+
+void pipe_io::async_read_some( unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	_pipe.async_read_some(boost::asio::buffer(buff, length), h);
+}
+
+void pipe_io::async_read( unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	boost::asio::async_read(_pipe, boost::asio::buffer(buff, length), h);
+}
+
+pipe_io::operator boost::asio::windows::stream_handle&()
+{
+	return _pipe;
+}
@@ -0,0 +1,50 @@
+#ifndef __PIPE_IO_H
+#define __PIPE_IO_H
+
+#include "stream_io_base.h"
+#include <boost/asio/windows/stream_handle.hpp>
+#include <string>
+
+class pipe_io;
+typedef std::shared_ptr<pipe_io> pipe_handle;
+
+/*!
+@brief 本机命名管道读写，双工字节流，与socket_io同一接口，text_stream_io等可直接运行在上面
+*/
+class pipe_io: public stream_io_base
+{
+private:
+	pipe_io(boost::asio::io_service& ios);
+public:
+	~pipe_io();
+	static pipe_handle create(boost::asio::io_service& ios);
+
+	/*!
+	@brief 创建一对已相互连接的管道，相当于socketpair
+	*/
+	static bool create_pair(boost::asio::io_service& ios, pipe_handle& first, pipe_handle& second);
+public:
+	/*!
+	@brief 服务端，创建命名管道并异步等待一个客户端连接，每个连接需要一个新的pipe_io
+	@param name 管道名，不含"\\\\.\\pipe\\"前缀
+	*/
+	void async_accept(const char* name, const std::function<void (const boost::system::error_code&)>& h);
+
+	/*!
+	@brief 客户端，连接到已存在的命名管道
+	*/
+	bool connect(const char* name);
+	void close();
+	void async_write(const unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h);
+	void async_write(const std::vector<boost::asio::const_buffer>& buffs, const std::function<void (const boost::system::error_code&, size_t)>& h);
+	void async_read_some(unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h);
+	void async_read(unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h);
+	operator boost::asio::windows::stream_handle& ();
+private:
+	static std::string pipe_name(const char* name);
+	static HANDLE create_server(const std::string& fullName, bool exclusive = false);
+private:
+	boost::asio::windows::stream_handle _pipe;
+};
+
+#endif
@@ -0,0 +1,205 @@
+#include "remote_actor.h"
+
+remote_node::remote_node()
+{
+	_peerID = 0;
+}
+
+remote_node::~remote_node()
+{
+
+}
+
+std::shared_ptr<remote_node> remote_node::create(shared_strand strand)
+{
+	std::shared_ptr<remote_node> res(new remote_node);
+	res->_strand = strand;
+	res->_weakThis = res;
+	return res;
+}
+
+bool remote_node::listen(size_t port)
+{
+	std::weak_ptr<remote_node> weakThis = _weakThis;
+	shared_strand strand = _strand;
+	accept_handle acceptor = acceptor_socket::create(_strand, port, [weakThis, strand](socket_handle socket)
+	{//accept在io线程中完成，和connect一样转到节点strand中建立对端
+		strand->dispatch([weakThis, socket]()
+		{
+			auto shared_this = weakThis.lock();
+			if (shared_this && socket)
+			{
+				shared_this->add_peer(socket, std::function<void (size_t)>());
+			}
+		});
+	});
+	boost::lock_guard<boost::mutex> lg(_mutex);
+	_acceptor = acceptor;
+	return !!acceptor;
+}
+
+void remote_node::connect(const char* ip, size_t port, const std::function<void (size_t peerID)>& h)
+{
+	std::shared_ptr<remote_node> shared_this = _weakThis.lock();
+	socket_handle socket = socket_io::create(_strand->get_io_service());
+	socket->async_connect(ip, port, _strand->wrap([shared_this, socket, h](const boost::system::error_code& ec)
+	{
+		if (ec)
+		{
+			h(0);
+			return;
+		}
+		shared_this->add_peer(socket, h);
+	}));
+}
+
+void remote_node::peer_notify(const std::function<void (size_t peerID, bool connected)>& h)
+{
+	boost::lock_guard<boost::mutex> lg(_mutex);
+	_peerNotify = h;
+}
+
+void remote_node::add_peer(socket_handle socket, const std::function<void (size_t)>& h)
+{
+	socket->no_delay();
+	std::weak_ptr<remote_node> weakThis = _weakThis;
+	size_t peerID;
+	std::function<void (size_t, bool)> peerNotify;
+	{
+		boost::lock_guard<boost::mutex> lg(_mutex);
+		peerID = ++_peerID;
+		peerNotify = _peerNotify;
+		_peers[peerID] = binary_stream_io::create(_strand, socket, [weakThis, peerID](shared_data msg)
+		{
+			auto shared_this = weakThis.lock();
+			if (shared_this)
+			{
+				shared_this->on_frame(peerID, msg);
+			}
+		});
+	}
+	if (h)
+	{
+		h(peerID);
+	}
+	if (peerNotify)
+	{
+		peerNotify(peerID, true);
+	}
+}
+
+void remote_node::on_frame(size_t peerID, shared_data msg)
+{
+	if (!msg)
+	{
+		std::function<void (size_t, bool)> peerNotify;
+		{
+			boost::lock_guard<boost::mutex> lg(_mutex);
+			_peers.erase(peerID);
+			peerNotify = _peerNotify;
+		}
+		if (peerNotify)
+		{
+			peerNotify(peerID, false);
+		}
+		return;
+	}
+	//帧格式: 1字节名字长度 + 名字 + 消息体
+	const char* p = msg->c_str();
+	size_t length = msg->size();
+	if (!length || length < head_size(std::string()) + (unsigned char)p[0])
+	{
+		return;
+	}
+	std::string name(p + 1, (unsigned char)p[0]);
+	std::function<bool (const char*, const char*)> h;
+	{
+		boost::lock_guard<boost::mutex> lg(_mutex);
+		auto it = _receivers.find(name);
+		if (it == _receivers.end())
+		{
+			return;
+		}
+		h = it->second;
+	}
+	h(p + head_size(name), p + length);
+}
+
+size_t remote_node::head_size(const std::string& name)
+{
+	assert(name.size() < 256);
+	return 1 + name.size();
+}
+
+void remote_node::regist(const std::string& name, const std::function<void (shared_data)>& h)
+{
+	regist_decoder(name, [h](const char* p, const char* end)->bool
+	{
+		h(msg_data::create(p, end - p));
+		return true;
+	});
+}
+
+void remote_node::regist_decoder(const std::string& name, const std::function<bool (const char*, const char*)>& h)
+{
+	assert(name.size() < 256);
+	boost::lock_guard<boost::mutex> lg(_mutex);
+	_receivers[name] = h;
+}
+
+void remote_node::unregist(const std::string& name)
+{
+	boost::lock_guard<boost::mutex> lg(_mutex);
+	_receivers.erase(name);
+}
+
+bool remote_node::post(size_t peerID, const std::string& name, shared_data msg)
+{
+	assert(msg);
+	if (!msg)
+	{
+		return false;
+	}
+	size_t headroom = head_size(name);
+	shared_data frame = msg_data::create(headroom + msg->size());
+	memcpy(frame->c_str() + headroom, msg->data(), msg->size());
+	return post_encoded(peerID, name, frame);
+}
+
+bool remote_node::post_encoded(size_t peerID, const std::string& name, shared_data msg)
+{
+	//消息体已在编码时预留了帧头空间
+	char* p = msg->c_str();
+	p[0] = (unsigned char)name.size();
+	memcpy(p + 1, name.c_str(), name.size());
+	std::shared_ptr<binary_stream_io> peer;
+	{
+		boost::lock_guard<boost::mutex> lg(_mutex);
+		auto it = _peers.find(peerID);
+		if (it == _peers.end())
+		{
+			return false;
+		}
+		peer = it->second;
+	}
+	return peer->write(msg);
+}
+
+void remote_node::close()
+{
+	accept_handle acceptor;
+	std::map<size_t, std::shared_ptr<binary_stream_io> > peers;
+	{
+		boost::lock_guard<boost::mutex> lg(_mutex);
+		acceptor.swap(_acceptor);
+		peers.swap(_peers);
+	}
+	if (acceptor)
+	{
+		acceptor->close();
+	}
+	for (auto it = peers.begin(); it != peers.end(); it++)
+	{
+		it->second->close();
+	}
+}
@@ -0,0 +1,336 @@
+#ifndef __REMOTE_ACTOR_H
+#define __REMOTE_ACTOR_H
+
+#include "actor_framework.h"
+#include "function_type.h"
+#include "binary_stream_io.h"
+#include "acceptor_socket.h"
+#include <boost/thread/mutex.hpp>
+#include <type_traits>
+#include <string>
+#include <map>
+
+/*!
+@brief 默认编解码器，参数按内存直接拷贝，只能用于POD类型；
+自定义编解码器提供同样的三个静态模板函数即可，通用类型可用msg_codec.h中的msg_codec
+*/
+struct pod_codec
+{
+	template <typename T>
+	static size_t size(const T& v)
+	{
+		static_assert(std::is_pod<T>::value, "pod_codec only supports POD types");
+		return sizeof(T);
+	}
+
+	template <typename T>
+	static char* encode(char* p, const T& v)
+	{
+		memcpy(p, &v, sizeof(T));
+		return p + sizeof(T);
+	}
+
+	/*!
+	@return 出错返回NULL
+	*/
+	template <typename T>
+	static const char* decode(const char* p, const char* end, T& v)
+	{
+		if ((size_t)(end - p) < sizeof(T))
+		{
+			return NULL;
+		}
+		memcpy(&v, p, sizeof(T));
+		return p + sizeof(T);
+	}
+};
+
+class remote_node;
+
+/*!
+@brief 按参数个数展开的编码/解码/投递，解码必须正好用完消息体，
+有多余数据或参数个数与注册的不符的帧丢弃
+*/
+template <typename Codec, typename T0, typename T1 = void, typename T2 = void, typename T3 = void>
+struct remote_param
+{
+	typedef typename func_type<T0, T1, T2, T3>::result handler_type;
+
+	static shared_data encode(size_t headroom, const T0& p0, const T1& p1, const T2& p2, const T3& p3)
+	{
+		shared_data msg = msg_data::create(headroom + Codec::size(p0) + Codec::size(p1) + Codec::size(p2) + Codec::size(p3));
+		char* p = msg->c_str() + headroom;
+		p = Codec::encode(p, p0);
+		p = Codec::encode(p, p1);
+		p = Codec::encode(p, p2);
+		Codec::encode(p, p3);
+		return msg;
+	}
+
+	static bool invoke(const char* p, const char* end, const handler_type& h)
+	{
+		msg_param<T0, T1, T2, T3> mp;
+		if ((p = Codec::decode(p, end, mp._res0)) && (p = Codec::decode(p, end, mp._res1)) &&
+			(p = Codec::decode(p, end, mp._res2)) && (p = Codec::decode(p, end, mp._res3)) && p == end)
+		{
+			h(mp._res0, mp._res1, mp._res2, mp._res3);
+			return true;
+		}
+		return false;
+	}
+
+	static handler_type make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name);
+};
+
+template <typename Codec, typename T0, typename T1, typename T2>
+struct remote_param<Codec, T0, T1, T2, void>
+{
+	typedef typename func_type<T0, T1, T2>::result handler_type;
+
+	static shared_data encode(size_t headroom, const T0& p0, const T1& p1, const T2& p2)
+	{
+		shared_data msg = msg_data::create(headroom + Codec::size(p0) + Codec::size(p1) + Codec::size(p2));
+		char* p = msg->c_str() + headroom;
+		p = Codec::encode(p, p0);
+		p = Codec::encode(p, p1);
+		Codec::encode(p, p2);
+		return msg;
+	}
+
+	static bool invoke(const char* p, const char* end, const handler_type& h)
+	{
+		msg_param<T0, T1, T2> mp;
+		if ((p = Codec::decode(p, end, mp._res0)) && (p = Codec::decode(p, end, mp._res1)) &&
+			(p = Codec::decode(p, end, mp._res2)) && p == end)
+		{
+			h(mp._res0, mp._res1, mp._res2);
+			return true;
+		}
+		return false;
+	}
+
+	static handler_type make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name);
+};
+
+template <typename Codec, typename T0, typename T1>
+struct remote_param<Codec, T0, T1, void, void>
+{
+	typedef typename func_type<T0, T1>::result handler_type;
+
+	static shared_data encode(size_t headroom, const T0& p0, const T1& p1)
+	{
+		shared_data msg = msg_data::create(headroom + Codec::size(p0) + Codec::size(p1));
+		char* p = msg->c_str() + headroom;
+		p = Codec::encode(p, p0);
+		Codec::encode(p, p1);
+		return msg;
+	}
+
+	static bool invoke(const char* p, const char* end, const handler_type& h)
+	{
+		msg_param<T0, T1> mp;
+		if ((p = Codec::decode(p, end, mp._res0)) && (p = Codec::decode(p, end, mp._res1)) && p == end)
+		{
+			h(mp._res0, mp._res1);
+			return true;
+		}
+		return false;
+	}
+
+	static handler_type make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name);
+};
+
+template <typename Codec, typename T0>
+struct remote_param<Codec, T0, void, void, void>
+{
+	typedef typename func_type<T0>::result handler_type;
+
+	static shared_data encode(size_t headroom, const T0& p0)
+	{
+		shared_data msg = msg_data::create(headroom + Codec::size(p0));
+		Codec::encode(msg->c_str() + headroom, p0);
+		return msg;
+	}
+
+	static bool invoke(const char* p, const char* end, const handler_type& h)
+	{
+		msg_param<T0> mp;
+		if (Codec::decode(p, end, mp._res0) == end)
+		{
+			h(mp._res0);
+			return true;
+		}
+		return false;
+	}
+
+	static handler_type make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name);
+};
+
+/*!
+@brief 远程Actor节点，本进程的Actor以名字注册后，其它节点上的Actor可以像本地投递消息一样向其投递；
+每个对端一个binary_stream_io连接，所有名字的消息在该连接上复用，发送队列与写合并由binary_stream_io完成
+*/
+class remote_node
+{
+	template <typename Codec, typename T0, typename T1, typename T2, typename T3>
+	friend struct remote_param;
+private:
+	remote_node();
+public:
+	~remote_node();
+	static std::shared_ptr<remote_node> create(shared_strand strand);
+public:
+	/*!
+	@brief 监听端口，接受其它节点连接，新连接在节点strand中加入
+	*/
+	bool listen(size_t port);
+
+	/*!
+	@brief 连接到其它节点，h 在节点strand中回调对端ID，失败为0
+	*/
+	void connect(const char* ip, size_t port, const std::function<void (size_t peerID)>& h);
+
+	/*!
+	@brief 对端连接建立/断开通知
+	*/
+	void peer_notify(const std::function<void (size_t peerID, bool connected)>& h);
+
+	/*!
+	@brief 以名字注册一个接收者，收到的原始消息体通过 h 通知
+	*/
+	void regist(const std::string& name, const std::function<void (shared_data)>& h);
+
+	/*!
+	@brief 以名字注册一个接收者，消息体用Codec解码后通过 h 通知(可直接传入make_msg_notifer)
+	*/
+	template <typename Codec, typename T0, typename T1, typename T2, typename T3>
+	void regist(const std::string& name, const std::function<void (T0, T1, T2, T3)>& h)
+	{
+		regist_decoder(name, [h](const char* p, const char* end)->bool
+		{
+			return remote_param<Codec, T0, T1, T2, T3>::invoke(p, end, h);
+		});
+	}
+
+	template <typename Codec, typename T0, typename T1, typename T2>
+	void regist(const std::string& name, const std::function<void (T0, T1, T2)>& h)
+	{
+		regist_decoder(name, [h](const char* p, const char* end)->bool
+		{
+			return remote_param<Codec, T0, T1, T2>::invoke(p, end, h);
+		});
+	}
+
+	template <typename Codec, typename T0, typename T1>
+	void regist(const std::string& name, const std::function<void (T0, T1)>& h)
+	{
+		regist_decoder(name, [h](const char* p, const char* end)->bool
+		{
+			return remote_param<Codec, T0, T1>::invoke(p, end, h);
+		});
+	}
+
+	template <typename Codec, typename T0>
+	void regist(const std::string& name, const std::function<void (T0)>& h)
+	{
+		regist_decoder(name, [h](const char* p, const char* end)->bool
+		{
+			return remote_param<Codec, T0>::invoke(p, end, h);
+		});
+	}
+	void unregist(const std::string& name);
+
+	/*!
+	@brief 向对端名为 name 的接收者投递原始消息体，msg 不能为空
+	*/
+	bool post(size_t peerID, const std::string& name, shared_data msg);
+
+	/*!
+	@brief 生成向对端名为 name 的接收者投递消息的函数，调用方式与本地的消息通知句柄相同
+	*/
+	template <typename Codec, typename T0, typename T1, typename T2, typename T3>
+	std::function<void (T0, T1, T2, T3)> make_poster(size_t peerID, const std::string& name)
+	{
+		return remote_param<Codec, T0, T1, T2, T3>::make_poster(_weakThis.lock(), peerID, name);
+	}
+
+	template <typename Codec, typename T0, typename T1, typename T2>
+	std::function<void (T0, T1, T2)> make_poster(size_t peerID, const std::string& name)
+	{
+		return remote_param<Codec, T0, T1, T2>::make_poster(_weakThis.lock(), peerID, name);
+	}
+
+	template <typename Codec, typename T0, typename T1>
+	std::function<void (T0, T1)> make_poster(size_t peerID, const std::string& name)
+	{
+		return remote_param<Codec, T0, T1>::make_poster(_weakThis.lock(), peerID, name);
+	}
+
+	template <typename Codec, typename T0>
+	std::function<void (T0)> make_poster(size_t peerID, const std::string& name)
+	{
+		return remote_param<Codec, T0>::make_poster(_weakThis.lock(), peerID, name);
+	}
+
+	/*!
+	@brief 关闭监听和所有连接
+	*/
+	void close();
+private:
+	static size_t head_size(const std::string& name);
+	bool post_encoded(size_t peerID, const std::string& name, shared_data msg);
+	void regist_decoder(const std::string& name, const std::function<bool (const char*, const char*)>& h);
+	void add_peer(socket_handle socket, const std::function<void (size_t)>& h);
+	void on_frame(size_t peerID, shared_data msg);
+private:
+	shared_strand _strand;
+	accept_handle _acceptor;
+	size_t _peerID;
+	std::map<size_t, std::shared_ptr<binary_stream_io> > _peers;
+	std::map<std::string, std::function<bool (const char*, const char*)> > _receivers;
+	std::function<void (size_t, bool)> _peerNotify;
+	std::weak_ptr<remote_node> _weakThis;
+	boost::mutex _mutex;
+};
+
+template <typename Codec, typename T0, typename T1, typename T2, typename T3>
+typename remote_param<Codec, T0, T1, T2, T3>::handler_type remote_param<Codec, T0, T1, T2, T3>::make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name)
+{
+	size_t headroom = remote_node::head_size(name);
+	return [node, peerID, name, headroom](const T0& p0, const T1& p1, const T2& p2, const T3& p3)
+	{
+		node->post_encoded(peerID, name, remote_param<Codec, T0, T1, T2, T3>::encode(headroom, p0, p1, p2, p3));
+	};
+}
+
+template <typename Codec, typename T0, typename T1, typename T2>
+typename remote_param<Codec, T0, T1, T2, void>::handler_type remote_param<Codec, T0, T1, T2, void>::make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name)
+{
+	size_t headroom = remote_node::head_size(name);
+	return [node, peerID, name, headroom](const T0& p0, const T1& p1, const T2& p2)
+	{
+		node->post_encoded(peerID, name, remote_param<Codec, T0, T1, T2>::encode(headroom, p0, p1, p2));
+	};
+}
+
+template <typename Codec, typename T0, typename T1>
+typename remote_param<Codec, T0, T1, void, void>::handler_type remote_param<Codec, T0, T1, void, void>::make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name)
+{
+	size_t headroom = remote_node::head_size(name);
+	return [node, peerID, name, headroom](const T0& p0, const T1& p1)
+	{
+		node->post_encoded(peerID, name, remote_param<Codec, T0, T1>::encode(headroom, p0, p1));
+	};
+}
+
+template <typename Codec, typename T0>
+typename remote_param<Codec, T0, void, void, void>::handler_type remote_param<Codec, T0, void, void, void>::make_poster(const std::shared_ptr<remote_node>& node, size_t peerID, const std::string& name)
+{
+	size_t headroom = remote_node::head_size(name);
+	return [node, peerID, name, headroom](const T0& p0)
+	{
+		node->post_encoded(peerID, name, remote_param<Codec, T0>::encode(headroom, p0));
+	};
+}
+
+#endif
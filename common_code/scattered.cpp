@@ -1,6 +1,13 @@
 #include "scattered.h"
 #include <assert.h>
 #include <Windows.h>
+#include <intrin.h>
+#include <boost/thread/once.hpp>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENABLE_SSE2_SCAN
+#endif
 
 #pragma comment( lib, "Winmm.lib" )
 
@@ -97,4 +104,60 @@ int get_tick_s()
 	LARGE_INTEGER quadPart;
 	QueryPerformanceCounter(&quadPart);
 	return (int)((double)quadPart.QuadPart*_pcCycle._sCycle);
-}
\ No newline at end of file
+}
+
+unsigned long long get_cycle()
+{
+	return __rdtsc();
+}
+
+static double _usPerCycle = 0;
+static boost::once_flag _cycleOnce = BOOST_ONCE_INIT;
+
+void calibrate_cycle()
+{
+	boost::call_once(_cycleOnce, []()
+	{
+		long long tk = get_tick_us();
+		unsigned long long cycle = __rdtsc();
+		Sleep(10);
+		unsigned long long dc = __rdtsc() - cycle;
+		long long dt = get_tick_us() - tk;
+		_usPerCycle = dc ? (double)dt / (double)dc : 0;
+	});
+}
+
+double cycle_to_us(unsigned long long cycles)
+{
+	calibrate_cycle();
+	return (double)cycles * _usPerCycle;
+}
+
+size_t find_crlf(const void* buff, size_t length)
+{
+	const char* p = (const char*)buff;
+	size_t i = 0;
+#ifdef ENABLE_SSE2_SCAN
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+		int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+		if (mask)
+		{
+			unsigned long bit;
+			_BitScanForward(&bit, (unsigned long)mask);
+			return i + bit;
+		}
+	}
+#endif
+	for (; i < length; i++)
+	{
+		if ('\r' == p[i] || '\n' == p[i])
+		{
+			return i;
+		}
+	}
+	return length;
+}
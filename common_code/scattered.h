@@ -13,23 +13,23 @@
 #undef LIBPATH
 
 /*!
-@brief ȡǰesp/rspջĴֵ
+@brief 获取当前esp/rsp栈顶寄存器值
 */
 extern "C" void* __stdcall get_sp();
 
 /*!
-@brief ȡCPU
+@brief 获取CPU计数
 */
 extern "C" unsigned long long __fastcall cpu_tick();
 
 #ifndef _WIN64
 
 /*!
-@brief 64λ32λעȷ̲ᳬ32bit
-@param a 
-@param b 
-@param pys 
-@return 
+@brief 64位整数除以32位整数，注意确保商不会超过32bit，否则程序发生致命错误
+@param a 被除数
+@param b 除数
+@param pys 返回余数
+@return 商
 */
 extern "C" unsigned __fastcall u64div32(unsigned long long a, unsigned b, unsigned* pys = 0);
 extern "C" int __fastcall i64div32(long long a, int b, int* pys = 0);
@@ -40,17 +40,17 @@ extern "C" int __fastcall i64div32(long long a, int b, int* pys = 0);
 #endif // _WIN64
 
 /*!
-@brief ø߾ʱ
+@brief 启用高精度时钟
 */
 void enable_high_resolution();
 
 /*!
-@brief ȨΪʵʱ
+@brief 程序优先权提升为“软实时”
 */
 void enable_realtime_priority();
 
 /*!
-@brief óȼ
+@brief 设置程序优先级
 REALTIME_PRIORITY_CLASS
 HIGH_PRIORITY_CLASS
 ABOVE_NORMAL_PRIORITY_CLASS
@@ -61,14 +61,36 @@ IDLE_PRIORITY_CLASS
 void set_priority(int p);
 
 /*!
-@brief ȡӲʱ
+@brief 获取硬件时间戳
 */
 long long get_tick_us();
 long long get_tick_ms();
 int get_tick_s();
 
 /*!
-@brief std::function
+@brief CPU时间戳计数器(TSC)，开销只有几十个时钟周期，用于短时间段计时
+*/
+unsigned long long get_cycle();
+
+/*!
+@brief 用高精度时钟校准TSC频率(阻塞约10ms)，只执行一次，线程安全；
+在启用各种计时统计时(程序启动阶段)调用，不要让第一次换算发生在调度线程中
+*/
+void calibrate_cycle();
+
+/*!
+@brief TSC周期数换算成微秒，还没有校准时先校准
+*/
+double cycle_to_us(unsigned long long cycles);
+
+/*!
+@brief 查找第一个'\r'或'\n'的位置，支持SSE2时每次比较16字节
+@return 偏移，没找到返回 length
+*/
+size_t find_crlf(const void* buff, size_t length);
+
+/*!
+@brief 清空std::function
 */
 template <typename F>
 inline void clear_function(F& f)
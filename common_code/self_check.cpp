@@ -0,0 +1,364 @@
+#include "self_check.h"
+#include "scattered.h"
+#include "actor_trace.h"
+#include "ios_proxy.h"
+#include <stdio.h>
+#include <typeinfo>
+
+//运行时间统计用例中子Actor忙等的时间和sleep次数
+#define CPU_STAT_BUSY_US	20000
+#define CPU_STAT_SLEEPS		5
+#define CPU_STAT_SLEEP_MS	10
+//跟踪用例中往返的消息数和导出的临时文件
+#define TRACE_MSGS			100
+#define TRACE_FILE			"self_check_trace.json"
+//看门狗阈值和故意阻塞调度线程的时间
+#define WATCHDOG_MS			50
+#define WATCHDOG_STALL_MS	300
+//唤醒延迟用例中跨strand往返的消息数
+#define WAKE_LATENCY_MSGS	100
+//快照用例中积压在子Actor邮箱里的消息数
+#define TREE_BACKLOG		3
+//栈统计用例中每个Actor至少用到的栈、Actor数和导出的临时文件
+#define STACK_TOUCH			(16 kB)
+#define STACK_ACTORS		4
+#define STACK_FILE			"self_check_stack.txt"
+
+/*!
+@brief 用掉 STACK_TOUCH 字节栈的入口，单独的类型使栈统计有自己的标签
+*/
+struct self_check_stack_user
+{
+	void operator()(my_actor* self) const
+	{
+		volatile char buf[STACK_TOUCH];
+		for (size_t i = 0; i < sizeof(buf); i += 64)
+		{
+			buf[i] = (char)i;
+		}
+	}
+};
+
+static std::string read_file(const char* fileName)
+{
+	std::string res;
+	FILE* file = NULL;
+	if (fopen_s(&file, fileName, "rb") || !file)
+	{
+		return res;
+	}
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), file)) > 0)
+	{
+		res.append(buf, n);
+	}
+	fclose(file);
+	return res;
+}
+
+static const actor_snapshot* find_snapshot(const std::vector<actor_snapshot>& nodes, long long actorID)
+{
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		if (actorID == nodes[i]._actorID)
+		{
+			return &nodes[i];
+		}
+		const actor_snapshot* res = find_snapshot(nodes[i]._children, actorID);
+		if (res)
+		{
+			return res;
+		}
+	}
+	return NULL;
+}
+
+static size_t count_of(const std::string& text, const char* pattern)
+{
+	size_t count = 0;
+	size_t len = strlen(pattern);
+	for (size_t pos = text.find(pattern); std::string::npos != pos; pos = text.find(pattern, pos + len))
+	{
+		count++;
+	}
+	return count;
+}
+
+self_check::self_check()
+{
+}
+
+void self_check::enable()
+{
+	my_actor::enable_cpu_stat();
+	actor_trace::enable();
+	wake_latency::enable();
+	my_actor::enable_actor_tree();
+	my_actor::enable_stack_profile();
+}
+
+bool self_check::run(my_actor* self)
+{
+	_results.clear();
+	check_cpu_stat(self);
+	check_trace(self);
+	check_watchdog(self);
+	check_wake_latency(self);
+	check_actor_tree(self);
+	check_stack_profile(self);
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		if (!_results[i]._ok)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+const std::vector<self_check_result>& self_check::results()
+{
+	return _results;
+}
+
+std::string self_check::report()
+{
+	std::string res;
+	char buf[512];
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		const self_check_result& r = _results[i];
+		sprintf_s(buf, "%-12s %s  %s\n", r._name.c_str(), r._ok ? "ok  " : "FAIL", r._detail.c_str());
+		res += buf;
+	}
+	return res;
+}
+
+void self_check::check(const char* name, bool ok, const char* detail)
+{
+	self_check_result r;
+	r._name = name;
+	r._detail = detail;
+	r._ok = ok;
+	_results.push_back(r);
+}
+
+void self_check::ping_pong(my_actor* self, const shared_strand& strand, int n)
+{//strand中的子Actor把收到的数原样发回，共往返 n 次
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	std::function<void (int)> toBuddy;
+	std::function<void (int)>* buddySlot = &toBuddy;
+	child_actor_handle buddy = self->create_child_actor(strand, [toSelf, buddySlot](my_actor* self)
+	{
+		actor_msg_handle<int> amh;
+		*buddySlot = self->make_msg_notifer(amh);
+		toSelf(-1);
+		while (true)
+		{
+			int i = self->wait_msg(amh);
+			if (i < 0)
+			{
+				break;
+			}
+			toSelf(i);
+		}
+		self->close_msg_notifer(amh);
+	});
+	self->child_actor_run(buddy);
+	self->wait_msg(amh);
+	for (int i = 0; i < n; i++)
+	{
+		toBuddy(i);
+		self->wait_msg(amh);
+	}
+	toBuddy(-1);
+	self->child_actor_wait_quit(buddy);
+	self->close_msg_notifer(amh);
+}
+
+void self_check::check_cpu_stat(my_actor* self)
+{//子Actor忙等后sleep几次，换算出的运行/定时器等待时间要和墙上时间对得上，同时验证了TSC校准
+	child_actor_handle worker = self->create_child_actor([](my_actor* self)
+	{
+		long long tk = get_tick_us();
+		while (get_tick_us() - tk < CPU_STAT_BUSY_US) {}
+		for (int i = 0; i < CPU_STAT_SLEEPS; i++)
+		{
+			self->sleep(CPU_STAT_SLEEP_MS);
+		}
+	});
+	long long elapsedUs = get_tick_us();
+	self->child_actor_run(worker);
+	self->child_actor_wait_quit(worker);
+	elapsedUs = get_tick_us() - elapsedUs;
+	actor_cpu_stat stat = worker.get_actor()->cpu_stat();
+	double runUs = cycle_to_us(stat._runCycles);
+	double timerUs = cycle_to_us(stat._timerWaitCycles);
+	char buf[256];
+	sprintf_s(buf, "run %.0fus, timer wait %.0fus, %d resumes in %lldus", runUs, timerUs, (int)stat._resumeCount, elapsedUs);
+	check("cpu_stat", runUs >= CPU_STAT_BUSY_US * 0.9 && runUs + timerUs <= elapsedUs * 1.1 &&
+		timerUs >= CPU_STAT_SLEEPS * CPU_STAT_SLEEP_MS * 1000 * 0.8 && stat._resumeCount >= CPU_STAT_SLEEPS + 1, buf);
+}
+
+void self_check::check_trace(my_actor* self)
+{//往返一批消息后导出，文件中要有本Actor的运行片段和每条消息的发送/接收事件
+	ping_pong(self, self->self_strand(), TRACE_MSGS);
+	bool dumped = actor_trace::dump_json(TRACE_FILE);
+	std::string json = dumped ? read_file(TRACE_FILE) : std::string();
+	remove(TRACE_FILE);
+	char actorName[64];
+	sprintf_s(actorName, "\"name\":\"actor %lld\"", self->self_id());
+	size_t slices = count_of(json, actorName);
+	size_t sends = count_of(json, "\"name\":\"msg send\"");
+	size_t recvs = count_of(json, "\"name\":\"msg recv\"");
+	bool closed = json.size() > 3 && 0 == json.compare(json.size() - 3, 3, "]}\n");
+	char buf[256];
+	sprintf_s(buf, "%d bytes, %d slices of actor %lld, %d msg send, %d msg recv", (int)json.size(), (int)slices, self->self_id(), (int)sends, (int)recvs);
+	check("trace", dumped && closed && slices >= 2 * TRACE_MSGS && sends >= 2 * TRACE_MSGS && recvs >= 2 * TRACE_MSGS, buf);
+}
+
+void self_check::check_watchdog(my_actor* self)
+{//在单独的调度器上先用普通handler、再用Actor阻塞调度线程，两次都要被看门狗报告并带回调用栈
+	ios_proxy watchIos(1);
+	actor_msg_handle<ios_stall_info> amh;
+	watchIos.enableWatchdog(WATCHDOG_MS, self->make_msg_notifer(amh));
+	watchIos.run(1);
+	shared_strand strand = boost_strand::create(watchIos);
+	strand->post([]()
+	{
+		Sleep(WATCHDOG_STALL_MS);
+	});
+	ios_stall_info handlerStall;
+	bool handlerReported = self->timed_wait_msg(WATCHDOG_STALL_MS * 10, amh, handlerStall);
+	child_actor_handle staller = self->create_child_actor(strand, [](my_actor* self)
+	{
+		Sleep(WATCHDOG_STALL_MS);
+	});
+	long long stallerID = staller.get_actor()->self_id();
+	self->child_actor_run(staller);
+	ios_stall_info actorStall;
+	bool actorReported = self->timed_wait_msg(WATCHDOG_STALL_MS * 10, amh, actorStall);
+	self->child_actor_wait_quit(staller);
+	self->close_msg_notifer(amh);
+	watchIos.stop();
+	char buf[256];
+	sprintf_s(buf, "handler %s after %dms (%d bytes backtrace), actor %lld %s after %dms (%d bytes backtrace)",
+		handlerReported ? "reported" : "missed", handlerReported ? handlerStall._elapsedMs : 0, handlerReported ? (int)handlerStall._backtrace.size() : 0,
+		stallerID, actorReported ? "reported" : "missed", actorReported ? actorStall._elapsedMs : 0, actorReported ? (int)actorStall._backtrace.size() : 0);
+	check("watchdog", handlerReported && 0 == handlerStall._actorID && handlerStall._elapsedMs >= WATCHDOG_MS && !handlerStall._backtrace.empty() &&
+		actorReported && stallerID == actorStall._actorID && actorStall._elapsedMs >= WATCHDOG_MS && !actorStall._backtrace.empty(), buf);
+}
+
+void self_check::check_wake_latency(my_actor* self)
+{//跨strand往返一批 actor_msg_handle 消息，全局合计的strand段和mailbox段都要有相应的记录
+	metric_histogram* strandPart = wake_latency::total(wake_latency::msg_mailbox, false);
+	metric_histogram* mailboxPart = wake_latency::total(wake_latency::msg_mailbox, true);
+	unsigned long long strandCount = strandPart->count();
+	unsigned long long strandSum = strandPart->sum();
+	unsigned long long mailboxCount = mailboxPart->count();
+	unsigned long long mailboxSum = mailboxPart->sum();
+	ping_pong(self, self->self_strand()->clone(), WAKE_LATENCY_MSGS);
+	strandCount = strandPart->count() - strandCount;
+	strandSum = strandPart->sum() - strandSum;
+	mailboxCount = mailboxPart->count() - mailboxCount;
+	mailboxSum = mailboxPart->sum() - mailboxSum;
+	char buf[256];
+	sprintf_s(buf, "strand %d records avg %.0fns, mailbox %d records avg %.0fns, %d messages",
+		(int)strandCount, strandCount ? (double)strandSum / strandCount : 0.0,
+		(int)mailboxCount, mailboxCount ? (double)mailboxSum / mailboxCount : 0.0, 2 * WAKE_LATENCY_MSGS);
+	check("wake_latency", strandCount >= WAKE_LATENCY_MSGS && strandSum && mailboxCount >= WAKE_LATENCY_MSGS, buf);
+}
+
+void self_check::check_actor_tree(my_actor* self)
+{//子Actor等待一个消息句柄，另一个句柄里积压几条消息，快照中它应挂在本Actor下(不是根)，处于等消息状态并能看到积压
+	actor_msg_handle<int> amh;
+	auto toSelf = self->make_msg_notifer(amh);
+	std::function<void (int)> toQuit;
+	std::function<void (int)> toBacklog;
+	std::function<void (int)>* quitSlot = &toQuit;
+	std::function<void (int)>* backlogSlot = &toBacklog;
+	child_actor_handle waiter = self->create_child_actor([toSelf, quitSlot, backlogSlot](my_actor* self)
+	{
+		actor_msg_handle<int> quitAmh;
+		actor_msg_handle<int> backlogAmh;
+		*quitSlot = self->make_msg_notifer(quitAmh);
+		*backlogSlot = self->make_msg_notifer(backlogAmh);
+		toSelf(0);
+		self->wait_msg(quitAmh);
+		self->close_msg_notifer(backlogAmh);
+		self->close_msg_notifer(quitAmh);
+	});
+	long long waiterID = waiter.get_actor()->self_id();
+	self->child_actor_run(waiter);
+	self->wait_msg(amh);
+	for (int i = 0; i < TREE_BACKLOG; i++)
+	{
+		toBacklog(i);
+	}
+	actor_msg_handle<std::shared_ptr<std::vector<actor_snapshot> > > snapAmh;
+	my_actor::snapshot_tree(self->make_msg_notifer(snapAmh));
+	std::shared_ptr<std::vector<actor_snapshot> > roots;
+	bool snapped = self->timed_wait_msg(1000, snapAmh, roots) && roots;
+	toQuit(0);
+	self->child_actor_wait_quit(waiter);
+	self->close_msg_notifer(snapAmh);
+	self->close_msg_notifer(amh);
+	const actor_snapshot* selfNode = NULL;
+	const actor_snapshot* waiterNode = NULL;
+	bool waiterIsRoot = false;
+	bool backlogSeen = false;
+	if (snapped)
+	{
+		selfNode = find_snapshot(*roots, self->self_id());
+		waiterNode = selfNode ? find_snapshot(selfNode->_children, waiterID) : NULL;
+		for (size_t i = 0; i < roots->size(); i++)
+		{
+			waiterIsRoot |= waiterID == (*roots)[i]._actorID;
+		}
+		for (size_t i = 0; waiterNode && i < waiterNode->_mailboxDepths.size(); i++)
+		{
+			backlogSeen |= TREE_BACKLOG == waiterNode->_mailboxDepths[i];
+		}
+	}
+	char buf[256];
+	sprintf_s(buf, "%d roots, actor %lld %s, child %lld %s%s, waiting %s, backlog %s", snapped ? (int)roots->size() : 0,
+		self->self_id(), selfNode ? "found" : "missing", waiterID, waiterNode ? "found" : "missing", waiterIsRoot ? " as root" : "",
+		waiterNode && actor_snapshot::wait_msg == waiterNode->_waitFor ? "msg" : "other", backlogSeen ? "seen" : "missing");
+	check("actor_tree", snapped && selfNode && waiterNode && !waiterIsRoot && self->self_id() == waiterNode->_parentID &&
+		actor_snapshot::wait_msg == waiterNode->_waitFor && backlogSeen, buf);
+}
+
+void self_check::check_stack_profile(my_actor* self)
+{//几个用掉固定栈的Actor退出后，统计值要覆盖实际用量，AUTO_STACKSIZE 按它创建的Actor要能跑完，保存/加载后建议值不变
+	const char* tag = typeid(self_check_stack_user).name();
+	for (int i = 0; i < STACK_ACTORS; i++)
+	{
+		child_actor_handle user = self->create_child_actor(self_check_stack_user(), 64 kB);
+		self->child_actor_run(user);
+		self->child_actor_wait_quit(user);
+	}
+	actor_stack_profile profile = actor_stack_profile();
+	std::vector<actor_stack_profile> profiles = my_actor::stack_profile();
+	for (size_t i = 0; i < profiles.size(); i++)
+	{
+		if (profiles[i]._tag == tag)
+		{
+			profile = profiles[i];
+		}
+	}
+	size_t autoSize = my_actor::auto_stack_size(tag);
+	child_actor_handle autoUser = self->create_child_actor(self_check_stack_user(), AUTO_STACKSIZE);
+	self->child_actor_run(autoUser);
+	bool autoRun = self->child_actor_wait_quit(autoUser);
+	bool saved = my_actor::save_stack_profile(STACK_FILE);
+	bool loaded = saved && my_actor::load_stack_profile(STACK_FILE);
+	size_t reloadSize = my_actor::auto_stack_size(tag);
+	remove(STACK_FILE);
+	char buf[256];
+	sprintf_s(buf, "%d actors, max used %d, auto size %d (%d after reload), auto-sized actor %s, save/load %s", (int)profile._count,
+		(int)profile._maxUsed, (int)autoSize, (int)reloadSize, autoRun ? "ran" : "failed", loaded ? "ok" : "failed");
+	check("stack_profile", profile._count >= STACK_ACTORS && profile._maxUsed >= STACK_TOUCH && autoSize > profile._maxUsed &&
+		autoRun && loaded && reloadSize == autoSize, buf);
+}
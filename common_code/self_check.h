@@ -0,0 +1,55 @@
+#ifndef __SELF_CHECK_H
+#define __SELF_CHECK_H
+
+#include "actor_framework.h"
+#include <string>
+#include <vector>
+
+/*!
+@brief 一项诊断功能的检查结果
+*/
+struct self_check_result
+{
+	std::string _name;
+	std::string _detail;///<实测数据
+	bool _ok;
+};
+
+/*!
+@brief 诊断功能自检，逐项启用运行时间统计等功能并检查其输出是否与实际运行情况相符
+*/
+class self_check
+{
+public:
+	self_check();
+public:
+	/*!
+	@brief 启用所有被检查的功能，在创建任何Actor之前调用
+	*/
+	static void enable();
+
+	/*!
+	@brief 运行所有检查
+	@return 全部通过返回true
+	*/
+	bool run(my_actor* self);
+
+	/*!
+	@brief 检查报告
+	*/
+	std::string report();
+	const std::vector<self_check_result>& results();
+private:
+	void check(const char* name, bool ok, const char* detail);
+	void ping_pong(my_actor* self, const shared_strand& strand, int n);
+	void check_cpu_stat(my_actor* self);
+	void check_trace(my_actor* self);
+	void check_watchdog(my_actor* self);
+	void check_wake_latency(my_actor* self);
+	void check_actor_tree(my_actor* self);
+	void check_stack_profile(my_actor* self);
+private:
+	std::vector<self_check_result> _results;
+};
+
+#endif
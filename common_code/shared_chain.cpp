@@ -0,0 +1,191 @@
+#include "shared_chain.h"
+#include <assert.h>
+
+msg_chain::msg_chain()
+{
+	_size = 0;
+}
+
+msg_chain::msg_chain(const msg_chain&)
+{
+
+}
+
+msg_chain& msg_chain::operator =(const msg_chain&)
+{
+	return *this;
+}
+
+msg_chain::~msg_chain()
+{
+
+}
+
+shared_chain msg_chain::create()
+{
+	return shared_chain(new msg_chain);
+}
+
+shared_chain msg_chain::create(const shared_data& msg)
+{
+	shared_chain r = create();
+	r->append(msg);
+	return r;
+}
+
+shared_chain msg_chain::create(const void* bf, size_t s, size_t fragSize)
+{
+	assert(fragSize > 0 && fragSize <= 1*1024*1024);
+	shared_chain r = create();
+	const char* p = (const char*)bf;
+	while (s)
+	{
+		size_t l = s < fragSize ? s : fragSize;
+		r->append(msg_data::create(p, l));
+		p += l;
+		s -= l;
+	}
+	return r;
+}
+
+void msg_chain::append(const shared_data& msg)
+{
+	append(msg, 0, msg->size());
+}
+
+void msg_chain::append(const shared_data& msg, size_t offset, size_t length)
+{
+	assert(msg && offset + length <= msg->size());
+	if (length)
+	{
+		fragment frag;
+		frag._data = msg;
+		frag._offset = offset;
+		frag._length = length;
+		_fragments.push_back(frag);
+		_size += length;
+	}
+}
+
+void msg_chain::append(const shared_chain& chain)
+{
+	assert(chain.get() != this);
+	for (auto it = chain->_fragments.begin(); it != chain->_fragments.end(); it++)
+	{
+		_fragments.push_back(*it);
+	}
+	_size += chain->_size;
+}
+
+void msg_chain::prepend(const shared_data& msg)
+{
+	prepend(msg, 0, msg->size());
+}
+
+void msg_chain::prepend(const shared_data& msg, size_t offset, size_t length)
+{
+	assert(msg && offset + length <= msg->size());
+	if (length)
+	{
+		fragment frag;
+		frag._data = msg;
+		frag._offset = offset;
+		frag._length = length;
+		_fragments.push_front(frag);
+		_size += length;
+	}
+}
+
+void msg_chain::prepend(const shared_chain& chain)
+{
+	assert(chain.get() != this);
+	for (auto it = chain->_fragments.rbegin(); it != chain->_fragments.rend(); it++)
+	{
+		_fragments.push_front(*it);
+	}
+	_size += chain->_size;
+}
+
+void msg_chain::consume(size_t n)
+{
+	assert(n <= _size);
+	while (n && !_fragments.empty())
+	{
+		fragment& frag = _fragments.front();
+		if (n < frag._length)
+		{
+			frag._offset += n;
+			frag._length -= n;
+			_size -= n;
+			return;
+		}
+		n -= frag._length;
+		_size -= frag._length;
+		_fragments.pop_front();
+	}
+}
+
+size_t msg_chain::size()
+{
+	return _size;
+}
+
+size_t msg_chain::count()
+{
+	return _fragments.size();
+}
+
+bool msg_chain::empty()
+{
+	return !_size;
+}
+
+void msg_chain::clear()
+{
+	_fragments.clear();
+	_size = 0;
+}
+
+size_t msg_chain::copy_to(void* dst, size_t offset, size_t length)
+{
+	char* p = (char*)dst;
+	size_t ct = 0;
+	for (auto it = _fragments.begin(); it != _fragments.end() && ct < length; it++)
+	{
+		if (offset >= it->_length)
+		{
+			offset -= it->_length;
+			continue;
+		}
+		size_t l = it->_length - offset;
+		if (l > length - ct)
+		{
+			l = length - ct;
+		}
+		memcpy(p + ct, (char*)it->_data->data() + it->_offset + offset, l);
+		ct += l;
+		offset = 0;
+	}
+	return ct;
+}
+
+shared_data msg_chain::flatten()
+{
+	if (1 == _fragments.size() && 0 == _fragments.front()._offset && _fragments.front()._length == _fragments.front()._data->size())
+	{
+		return _fragments.front()._data;
+	}
+	shared_data r = msg_data::create(_size);
+	copy_to(r->data(), 0, _size);
+	return r;
+}
+
+size_t msg_chain::buffers(std::vector<boost::asio::const_buffer>& buffs)
+{
+	buffs.reserve(buffs.size() + _fragments.size());
+	for (auto it = _fragments.begin(); it != _fragments.end(); it++)
+	{
+		buffs.push_back(boost::asio::const_buffer((char*)it->_data->data() + it->_offset, it->_length));
+	}
+	return _size;
+}
@@ -0,0 +1,87 @@
+#ifndef __SHARED_CHAIN_H
+#define __SHARED_CHAIN_H
+
+#include "shared_data.h"
+#include <boost/asio/buffer.hpp>
+#include <list>
+#include <vector>
+
+/*!
+@brief 分段消息包，由多个msg_data片段链接而成，前后追加不拷贝数据，可超过单个msg_data 1M的限制
+*/
+class msg_chain;
+typedef std::shared_ptr<msg_chain> shared_chain;
+class msg_chain
+{
+	struct fragment
+	{
+		shared_data _data;
+		size_t _offset;
+		size_t _length;
+	};
+private:
+	msg_chain();
+	msg_chain(const msg_chain&);
+	msg_chain& operator =(const msg_chain&);
+public:
+	~msg_chain();
+	static shared_chain create();
+	static shared_chain create(const shared_data& msg);
+	/*!
+	@brief 拷贝一段数据到新的分段包中，每个片段最大 fragSize 字节
+	*/
+	static shared_chain create(const void* bf, size_t s, size_t fragSize = 64*1024);
+public:
+	/*!
+	@brief 在尾部追加一个片段(不拷贝)
+	*/
+	void append(const shared_data& msg);
+	void append(const shared_data& msg, size_t offset, size_t length);
+	void append(const shared_chain& chain);
+
+	/*!
+	@brief 在头部插入一个片段(不拷贝)，用于添加协议头
+	*/
+	void prepend(const shared_data& msg);
+	void prepend(const shared_data& msg, size_t offset, size_t length);
+	void prepend(const shared_chain& chain);
+
+	/*!
+	@brief 从头部丢弃 n 字节
+	*/
+	void consume(size_t n);
+
+	/*!
+	@brief 总字节数
+	*/
+	size_t size();
+
+	/*!
+	@brief 片段数
+	*/
+	size_t count();
+	bool empty();
+	void clear();
+
+	/*!
+	@brief 把从 offset 开始的 length 字节拷贝到 dst
+	@return 实际拷贝的字节数
+	*/
+	size_t copy_to(void* dst, size_t offset, size_t length);
+
+	/*!
+	@brief 合并成一个连续的msg_data(有拷贝)，总长度不能超过1M
+	*/
+	shared_data flatten();
+
+	/*!
+	@brief 导出scatter-gather写列表，追加到 buffs 尾部，用于 stream_io_base::async_write 一次写出
+	@return 追加的字节数
+	*/
+	size_t buffers(std::vector<boost::asio::const_buffer>& buffs);
+private:
+	std::list<fragment> _fragments;
+	size_t _size;
+};
+
+#endif
@@ -5,7 +5,7 @@
 #include <functional>
 
 /*!
-@brief Ϣ
+@brief 消息包
 */
 class msg_data;
 typedef std::shared_ptr<msg_data> shared_data;
@@ -1,13 +1,77 @@
 #include "shared_strand.h"
+#include "actor_metrics.h"
+#include "scattered.h"
+
+bool wake_latency::_enabled = false;
+static metric_histogram* _wakeLatencyTotal[wake_latency::mailbox_type_number][2] = { { NULL } };
+
+void wake_latency::enable()
+{
+	if (!_enabled)
+	{
+		calibrate_cycle();
+		_wakeLatencyTotal[msg_mailbox][0] = metrics_registry::histogram("actor_msg_strand_latency_ns", "actor_msg_handle send to mailbox push");
+		_wakeLatencyTotal[msg_mailbox][1] = metrics_registry::histogram("actor_msg_mailbox_latency_ns", "actor_msg_handle mailbox push to actor read");
+		_wakeLatencyTotal[trig_mailbox][0] = metrics_registry::histogram("actor_trig_strand_latency_ns", "actor_trig_handle send to mailbox push");
+		_wakeLatencyTotal[trig_mailbox][1] = metrics_registry::histogram("actor_trig_mailbox_latency_ns", "actor_trig_handle mailbox push to actor read");
+		_wakeLatencyTotal[pump_mailbox][0] = metrics_registry::histogram("actor_pump_strand_latency_ns", "post_actor_msg send to msg_pool push");
+		_enabled = true;
+	}
+}
+
+unsigned long long wake_latency::now()
+{
+	return get_cycle();
+}
+
+unsigned long long wake_latency::on_push(boost_strand* strand, mailbox_type type, unsigned long long sendCycle)
+{
+	unsigned long long pushCycle = get_cycle();
+	if (sendCycle && pushCycle > sendCycle)
+	{
+		unsigned long long ns = (unsigned long long)(cycle_to_us(pushCycle - sendCycle) * 1000);
+		_wakeLatencyTotal[type][0]->record(ns);
+		if (strand->_wakeLatency)
+		{
+			strand->_wakeLatency->_strand.record(ns);
+		}
+	}
+	return pushCycle;
+}
+
+void wake_latency::on_read(boost_strand* strand, mailbox_type type, unsigned long long pushCycle)
+{
+	unsigned long long readCycle = get_cycle();
+	if (pushCycle && readCycle > pushCycle)
+	{
+		unsigned long long ns = (unsigned long long)(cycle_to_us(readCycle - pushCycle) * 1000);
+		_wakeLatencyTotal[type][1]->record(ns);
+		if (strand->_wakeLatency)
+		{
+			strand->_wakeLatency->_mailbox.record(ns);
+		}
+	}
+}
+
+metric_histogram* wake_latency::total(mailbox_type type, bool mailboxPart)
+{
+	assert(_enabled);
+	return _wakeLatencyTotal[type][mailboxPart ? 1 : 0];
+}
 
 boost_strand::boost_strand()
 {
 	_iosProxy = NULL;
 	_strand = NULL;
+	_wakeLatency = wake_latency::enabled() ? new wake_latency : NULL;
+	RUNTIME_METRIC(_strandCreated.add());
+	RUNTIME_METRIC(_strandAlive.add());
 }
 
 boost_strand::~boost_strand()
 {
+	RUNTIME_METRIC(_strandAlive.sub());
+	delete _wakeLatency;
 	if (_strand)
 	{
 		delete _strand;
@@ -57,6 +121,23 @@ boost::asio::io_service& boost_strand::get_io_service()
 	return *_iosProxy;
 }
 
+actor_cpu_stat boost_strand::cpu_stat()
+{
+	assert(running_in_this_thread());
+	return _cpuStat;
+}
+
+void boost_strand::reset_cpu_stat()
+{
+	assert(running_in_this_thread());
+	_cpuStat = actor_cpu_stat();
+}
+
+wake_latency* boost_strand::get_wake_latency()
+{
+	return _wakeLatency;
+}
+
 #ifdef ENABLE_MFC_ACTOR
 void boost_strand::_post( const std::function<void ()>& h )
 {
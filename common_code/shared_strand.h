@@ -6,7 +6,7 @@
 #include "strand_ex.h"
 #else
 //#define BOOST_ASIO_ENABLE_SEQUENTIAL_STRAND_ALLOCATION
-//#define BOOST_ASIO_STRAND_IMPLEMENTATIONS	11//iosstrandĿص
+//#define BOOST_ASIO_STRAND_IMPLEMENTATIONS	11//单个ios中strand最大数目（超过会重叠）
 #include <boost/asio/strand.hpp>
 #endif //end ENABLE_SHARE_STRAND_IMPL
 
@@ -18,15 +18,92 @@
 #include "ios_proxy.h"
 #include "wrapped_post_handler.h"
 #include "wrapped_dispatch_handler.h"
+#include "actor_trace.h"
+#include "actor_metrics.h"
 
 class boost_strand;
+class my_actor;
 typedef std::shared_ptr<boost_strand> shared_strand;
 
 /*!
-@brief ¶dispatchʵ֣вͬstrandϢʽк
+@brief Actor运行时间统计，时间单位为TSC周期(用 cycle_to_us 换算)，需先调用 my_actor::enable_cpu_stat()
+*/
+struct actor_cpu_stat
+{
+	actor_cpu_stat()
+		:_runCycles(0), _maxSliceCycles(0), _msgWaitCycles(0), _timerWaitCycles(0), _resumeCount(0) {}
+
+	unsigned long long _runCycles;///<累计运行时间
+	unsigned long long _maxSliceCycles;///<最长的一次连续运行时间
+	unsigned long long _msgWaitCycles;///<等待消息/触发的时间
+	unsigned long long _timerWaitCycles;///<sleep等待定时器的时间
+	size_t _resumeCount;///<被调度运行的次数
+};
+
+/*!
+@brief 消息唤醒延迟统计(ns)，strand段为从发送到在接收方strand中投递进邮箱，
+mailbox段为从进入邮箱到被等待的Actor取出，两段相加为消息从发出到接收Actor恢复运行的时间；
+每个strand一份(boost_strand::get_wake_latency)，按邮箱类型另有全局合计(导出到metrics_registry)
+*/
+class wake_latency
+{
+public:
+	enum mailbox_type
+	{
+		msg_mailbox = 0,///<actor_msg_handle
+		trig_mailbox,///<actor_trig_handle
+		pump_mailbox,///<post_actor_msg/msg_pump
+		mailbox_type_number
+	};
+public:
+	/*!
+	@brief 启用消息时间戳，在创建strand和Actor之前调用
+	*/
+	static void enable();
+
+	static bool enabled()
+	{
+		return _enabled;
+	}
+
+	/*!
+	@brief 发送时的时间戳，未启用时为0
+	*/
+	static unsigned long long stamp()
+	{
+		return _enabled ? now() : 0;
+	}
+
+	/*!
+	@brief 消息在接收方strand中进入邮箱，记录strand段(sendCycle为0时不记录)，返回进入邮箱的时间戳
+	*/
+	static unsigned long long on_push(boost_strand* strand, mailbox_type type, unsigned long long sendCycle);
+
+	/*!
+	@brief 消息被Actor取出，记录mailbox段
+	*/
+	static void on_read(boost_strand* strand, mailbox_type type, unsigned long long pushCycle);
+
+	/*!
+	@brief 某类邮箱的全局合计，pump_mailbox只有strand段(mailbox段返回NULL)
+	*/
+	static metric_histogram* total(mailbox_type type, bool mailboxPart);
+private:
+	static unsigned long long now();
+public:
+	metric_histogram _strand;
+	metric_histogram _mailbox;
+private:
+	static bool _enabled;
+};
+
+/*!
+@brief 重新定义dispatch实现，所有不同strand中以消息方式进行函数调用
 */
 class boost_strand
 {
+	friend my_actor;
+	friend wake_latency;
 #ifdef ENABLE_STRAND_IMPL_POOL
 	typedef strand_ex strand_type;
 #else
@@ -39,14 +116,24 @@ public:
 	static shared_strand create(ios_proxy& iosProxy);
 public:
 	/*!
-	@brief ڱstrandеֱִУӵеȴִ
-	@param handler ú
+	@brief 如果在本strand中调用则直接执行，否则添加到队列中等待执行
+	@param handler 被调用函数
 	*/
 	template <typename Handler>
 	void dispatch(const Handler& handler)
 	{
 		if (running_in_this_thread())
 		{
+			if (ios_proxy::watching())
+			{//wrap后的完成回调在这里直接运行，同样要计时
+				bool outer = ios_proxy::watchBegin();
+				handler();
+				if (outer)
+				{
+					ios_proxy::watchEnd();
+				}
+				return;
+			}
 			handler();
 		} 
 		else
@@ -56,10 +143,35 @@ public:
 	}
 
 	/*!
-	@brief һstrand
+	@brief 添加一个任务到strand队列
 	*/
 	template <typename Handler>
 	void post(const Handler& handler)
+	{
+		if (actor_trace::enabled())
+		{
+			actor_trace::record(trace_strand_post, 0);
+		}
+		RUNTIME_METRIC(_strandPosts.add());
+		if (ios_proxy::watching())
+		{//标记handler开始时间，供看门狗检查
+			Handler h = handler;
+			post_([h]() mutable
+			{
+				bool outer = ios_proxy::watchBegin();
+				h();
+				if (outer)
+				{
+					ios_proxy::watchEnd();
+				}
+			});
+			return;
+		}
+		post_(handler);
+	}
+private:
+	template <typename Handler>
+	void post_(const Handler& handler)
 	{
 #ifndef ENABLE_MFC_ACTOR
 		_strand->post(handler);
@@ -74,9 +186,9 @@ public:
 		}
 #endif
 	}
-
+public:
 	/*!
-	@brief ѱúװdispatchУڲͬstrandϢ
+	@brief 把被调用函数包装到dispatch中，用于不同strand间消息传递
 	*/
 	template <typename Handler>
 	wrapped_dispatch_handler<boost_strand, Handler> wrap(const Handler& handler)
@@ -85,7 +197,7 @@ public:
 	}
 	
 	/*!
-	@brief ѱúװpost
+	@brief 把被调用函数包装到post中
 	*/
 	template <typename Handler>
 	wrapped_post_handler<boost_strand, Handler> wrap_post(const Handler& handler)
@@ -94,46 +206,59 @@ public:
 	}
 
 	/*!
-	@brief һͬһiosstrand
+	@brief 复制一个依赖同一个ios的strand
 	*/
 	virtual shared_strand clone();
 
 	/*!
-	@brief Ƿiosִ߳
-	@return true , false 
+	@brief 检查是否在所依赖ios线程中执行
+	@return true 在, false 不在
 	*/
 	virtual bool in_this_ios();
 
 	/*!
-	@brief ios߳
+	@brief 依赖的ios调度器运行线程数
 	*/
 	size_t ios_thread_number();
 
 	/*!
-	@brief жǷڱstrand
+	@brief 判断是否在本strand中运行
 	*/
 	virtual bool running_in_this_thread();
 
 	/*!
-	@brief ȡǰ
+	@brief 获取当前调度器代理
 	*/
 	ios_proxy& get_ios_proxy();
 
 	/*!
-	@brief ȡǰ
+	@brief 获取当前调度器
 	*/
 	boost::asio::io_service& get_io_service();
 
+	/*!
+	@brief 本strand中所有Actor的运行时间统计合计，在本strand中调用
+	*/
+	actor_cpu_stat cpu_stat();
+	void reset_cpu_stat();
+
+	/*!
+	@brief 本strand的消息唤醒延迟统计，未启用 wake_latency::enable() 时为NULL，可在任意线程读取
+	*/
+	wake_latency* get_wake_latency();
+
 #ifdef ENABLE_MFC_ACTOR
 	virtual void _post(const std::function<void ()>& h);
 #endif
 protected:
 	ios_proxy* _iosProxy;
 	strand_type* _strand;
+	actor_cpu_stat _cpuStat;
+	wake_latency* _wakeLatency;
 public:
 	/*!
-	@brief һstrandеĳֱִɺŷ
-	@warning ˺пʹֻstrandios޹߳е
+	@brief 在一个strand中调用某个函数，直到这个函数被执行完成后才返回
+	@warning 此函数有可能使整个程序陷入死锁，只能在与strand所依赖的ios无关线程中调用
 	*/
 	template <typename H>
 	void syncInvoke(const H& h)
@@ -153,7 +278,7 @@ public:
 	}
 
 	/*!
-	@brief ͬϣֵ
+	@brief 同上，带返回值
 	*/
 	template <typename R, typename H>
 	R syncInvoke(const H& h)
@@ -175,8 +300,8 @@ public:
 	}
 
 	/*!
-	@brief strandеĳֵȻͨһصѷֵ
-	@param cb ĺ
+	@brief 在strand中调用某个带返回值函数，然后通过一个回调函数把返回值传出
+	@param cb 传出参数的函数
 	*/
 	template <typename H, typename CB>
 	void asyncInvoke(const H& h, const CB& cb)
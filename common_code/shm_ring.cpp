@@ -0,0 +1,325 @@
+#include "shm_ring.h"
+#include <boost/atomic/atomic.hpp>
+
+#define SHM_RING_MAGIC		0x52494E47
+#define SHM_RECORD_HEAD		8
+#define SHM_RECORD_WRAP		0xFFFFFFFF
+#define SHM_ALIGN(__n__)	(((__n__) + 7) & ~(size_t)7)
+//每读出这么多条记录让出一次strand
+#define SHM_YIELD_RECORDS	256
+//单个记录最大长度，与msg_data的上限一致
+#define SHM_MAX_MSG			(1*1024*1024)
+
+/*!
+@brief 共享段头部，后面紧跟 _capacity 字节的环形区；
+每个记录为8字节头(4字节长度)+数据，按8字节对齐，尾部放不下时写一个回绕标记从头开始
+*/
+struct shm_ring_head
+{
+	unsigned _magic;
+	unsigned _multiWriter;
+	size_t _capacity;
+	boost::atomic<size_t> _writePos;//累计写入字节数
+	boost::atomic<size_t> _readPos;//累计读出字节数
+	boost::atomic<unsigned> _waiting;//读端准备等待唤醒事件
+	boost::atomic<unsigned> _writeLock;//多写端锁
+};
+
+static std::string mapping_name(const char* name)
+{
+	return std::string("Local\\actor_shm_ring_") + name;
+}
+
+static std::string event_name(const char* name)
+{
+	return std::string("Local\\actor_shm_ring_event_") + name;
+}
+//////////////////////////////////////////////////////////////////////////
+
+shm_ring_reader::shm_ring_reader(shared_strand strand)
+: _strand(strand), _event(strand->get_io_service())
+{
+	_closed = false;
+	_corrupt = false;
+	_capacity = 0;
+	_mapping = NULL;
+	_head = NULL;
+	_ring = NULL;
+}
+
+shm_ring_reader::~shm_ring_reader()
+{
+	if (_head)
+	{
+		UnmapViewOfFile(_head);
+	}
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+	}
+}
+
+std::shared_ptr<shm_ring_reader> shm_ring_reader::create(shared_strand strand, const char* name, size_t capacity, const std::function<void (shared_data)>& h, bool multiWriter)
+{
+	assert(capacity >= 64);
+	size_t ringSize = 64;
+	while (ringSize < capacity)
+	{
+		ringSize <<= 1;
+	}
+	std::shared_ptr<shm_ring_reader> res(new shm_ring_reader(strand));
+	unsigned long long mapSize = sizeof(shm_ring_head) + ringSize;
+	res->_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(mapSize >> 32), (DWORD)mapSize, mapping_name(name).c_str());
+	if (!res->_mapping || ERROR_ALREADY_EXISTS == GetLastError())
+	{
+		return std::shared_ptr<shm_ring_reader>();
+	}
+	res->_head = (shm_ring_head*)MapViewOfFile(res->_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (!res->_head)
+	{
+		return std::shared_ptr<shm_ring_reader>();
+	}
+	HANDLE event = CreateEventA(NULL, FALSE, FALSE, event_name(name).c_str());
+	if (!event)
+	{
+		return std::shared_ptr<shm_ring_reader>();
+	}
+	boost::system::error_code ec;
+	res->_event.assign(event, ec);
+	if (ec)
+	{
+		CloseHandle(event);
+		return std::shared_ptr<shm_ring_reader>();
+	}
+	res->_ring = (char*)res->_head + sizeof(shm_ring_head);
+	new(res->_head)shm_ring_head();
+	res->_head->_multiWriter = multiWriter ? 1 : 0;
+	res->_head->_capacity = ringSize;
+	res->_capacity = ringSize;
+	res->_head->_writePos = 0;
+	res->_head->_readPos = 0;
+	res->_head->_waiting = 0;
+	res->_head->_writeLock = 0;
+	boost::atomic_thread_fence(boost::memory_order_seq_cst);
+	res->_head->_magic = SHM_RING_MAGIC;
+	res->_msgNotify = h;
+	res->_weakThis = res;
+	my_actor::create(strand, [res](my_actor* self){res->readActor(self); })->notify_run();
+	return res;
+}
+
+void shm_ring_reader::close()
+{
+	std::shared_ptr<shm_ring_reader> shared_this = _weakThis.lock();
+	if (shared_this)
+	{
+		_strand->post([shared_this]()
+		{
+			shared_this->_closed = true;
+			boost::system::error_code ec;
+			shared_this->_event.cancel(ec);
+		});
+	}
+}
+
+bool shm_ring_reader::drain()
+{
+	//共享段可被任何打开同名段的进程改写，容量用本地保存的，长度和位置都要检查
+	const size_t capacity = _capacity;
+	const size_t mask = capacity - 1;
+	size_t r = _head->_readPos.load(boost::memory_order_relaxed);
+	size_t w = _head->_writePos.load(boost::memory_order_acquire);
+	if (r == w)
+	{
+		return false;
+	}
+	if (w - r > capacity)
+	{
+		_corrupt = true;
+		return false;
+	}
+	size_t count = 0;
+	while (r != w && count < SHM_YIELD_RECORDS)
+	{
+		size_t offset = r & mask;
+		unsigned length = *(unsigned*)(_ring + offset);
+		if (SHM_RECORD_WRAP == length)
+		{
+			if (capacity - offset > w - r)
+			{
+				_corrupt = true;
+				break;
+			}
+			r += capacity - offset;
+			continue;
+		}
+		if (length > SHM_MAX_MSG || length > capacity - offset - SHM_RECORD_HEAD || SHM_ALIGN(SHM_RECORD_HEAD + length) > w - r)
+		{
+			_corrupt = true;
+			break;
+		}
+		shared_data msg = msg_data::create(_ring + offset + SHM_RECORD_HEAD, length);
+		r += SHM_ALIGN(SHM_RECORD_HEAD + length);
+		_head->_readPos.store(r, boost::memory_order_release);
+		_msgNotify(msg);
+		count++;
+	}
+	_head->_readPos.store(r, boost::memory_order_release);
+	return true;
+}
+
+void shm_ring_reader::readActor(my_actor* self)
+{
+	while (!_closed)
+	{
+		bool drained = drain();
+		if (_corrupt)
+		{//记录长度或位置不合法，当作队列已关闭
+			break;
+		}
+		if (drained)
+		{
+			self->sleep(0);
+			continue;
+		}
+		//先声明要等待再检查一次，写端提交后看到_waiting才发事件
+		_head->_waiting.store(1);
+		if (_head->_writePos.load() != _head->_readPos.load(boost::memory_order_relaxed))
+		{
+			_head->_waiting.store(0);
+			continue;
+		}
+		actor_trig_handle<boost::system::error_code> ath;
+		_event.async_wait(self->make_trig_notifer(ath));
+		boost::system::error_code ec = self->wait_trig(ath);
+		_head->_waiting.store(0);
+		if (ec)
+		{
+			break;
+		}
+	}
+	_msgNotify(shared_data());
+	clear_function(_msgNotify);
+	boost::system::error_code ec;
+	_event.close(ec);
+}
+//////////////////////////////////////////////////////////////////////////
+
+shm_ring_writer::shm_ring_writer()
+{
+	_mapping = NULL;
+	_event = NULL;
+	_head = NULL;
+	_ring = NULL;
+	_allocPos = 0;
+	_allocLength = 0;
+}
+
+shm_ring_writer::~shm_ring_writer()
+{
+	if (_head)
+	{
+		UnmapViewOfFile(_head);
+	}
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+	}
+	if (_event)
+	{
+		CloseHandle(_event);
+	}
+}
+
+std::shared_ptr<shm_ring_writer> shm_ring_writer::open(const char* name)
+{
+	std::shared_ptr<shm_ring_writer> res(new shm_ring_writer);
+	res->_mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mapping_name(name).c_str());
+	if (!res->_mapping)
+	{
+		return std::shared_ptr<shm_ring_writer>();
+	}
+	res->_head = (shm_ring_head*)MapViewOfFile(res->_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (!res->_head || SHM_RING_MAGIC != res->_head->_magic)
+	{
+		return std::shared_ptr<shm_ring_writer>();
+	}
+	res->_event = OpenEventA(EVENT_MODIFY_STATE, FALSE, event_name(name).c_str());
+	if (!res->_event)
+	{
+		return std::shared_ptr<shm_ring_writer>();
+	}
+	res->_ring = (char*)res->_head + sizeof(shm_ring_head);
+	return res;
+}
+
+void shm_ring_writer::unlock()
+{
+	if (_head->_multiWriter)
+	{
+		_head->_writeLock.store(0, boost::memory_order_release);
+	}
+}
+
+void* shm_ring_writer::alloc(size_t length)
+{
+	assert(!_allocLength);
+	const size_t capacity = _head->_capacity;
+	const size_t need = SHM_ALIGN(SHM_RECORD_HEAD + length);
+	assert(need <= capacity / 2 && length <= SHM_MAX_MSG);
+	if (_head->_multiWriter)
+	{
+		while (_head->_writeLock.exchange(1, boost::memory_order_acquire))
+		{
+			YieldProcessor();
+		}
+	}
+	size_t w = _head->_writePos.load(boost::memory_order_relaxed);
+	size_t r = _head->_readPos.load(boost::memory_order_acquire);
+	size_t offset = w & (capacity - 1);
+	size_t skip = capacity - offset < need ? capacity - offset : 0;
+	if (w + skip + need - r > capacity)
+	{
+		unlock();
+		return NULL;
+	}
+	if (skip)
+	{
+		*(unsigned*)(_ring + offset) = SHM_RECORD_WRAP;
+		w += skip;
+		offset = 0;
+	}
+	_allocPos = w;
+	_allocLength = need;
+	return _ring + offset + SHM_RECORD_HEAD;
+}
+
+void shm_ring_writer::commit(size_t length)
+{
+	assert(_allocLength && SHM_ALIGN(SHM_RECORD_HEAD + length) <= _allocLength);
+	*(unsigned*)(_ring + (_allocPos & (_head->_capacity - 1))) = (unsigned)length;
+	_head->_writePos.store(_allocPos + SHM_ALIGN(SHM_RECORD_HEAD + length));
+	_allocLength = 0;
+	unlock();
+	if (_head->_waiting.load())
+	{
+		SetEvent(_event);
+	}
+}
+
+bool shm_ring_writer::write(const void* data, size_t length)
+{
+	void* p = alloc(length);
+	if (!p)
+	{
+		return false;
+	}
+	memcpy(p, data, length);
+	commit(length);
+	return true;
+}
+
+bool shm_ring_writer::write(shared_data msg)
+{
+	return write(msg->data(), msg->size());
+}
@@ -0,0 +1,95 @@
+#ifndef __SHM_RING_H
+#define __SHM_RING_H
+
+#include "actor_framework.h"
+#include "shared_data.h"
+#include <boost/asio/windows/object_handle.hpp>
+#include <string>
+
+struct shm_ring_head;
+
+/*!
+@brief 跨进程共享内存环形队列的读端，创建命名共享内存段和唤醒事件，
+在strand中运行一个读Actor，把收到的每个消息通过 h 通知(可直接传入make_msg_notifer)，关闭时参数为空；
+共享段可被其它进程改写，读到不合法的记录长度或位置时停止读取，同样以空消息通知
+*/
+class shm_ring_reader
+{
+private:
+	shm_ring_reader(shared_strand strand);
+public:
+	~shm_ring_reader();
+	/*!
+	@brief 创建队列
+	@param name 队列名，写端用同一名字打开
+	@param capacity 环形区字节数，取整到2的幂
+	@param multiWriter 是否允许多个写端(多进程)同时写入
+	*/
+	static std::shared_ptr<shm_ring_reader> create(shared_strand strand, const char* name, size_t capacity, const std::function<void (shared_data)>& h, bool multiWriter = false);
+public:
+	void close();
+private:
+	void readActor(my_actor* self);
+
+	/*!
+	@brief 读出一批记录(最多 SHM_YIELD_RECORDS 条)，遇到不合法的记录时置 _corrupt 并停止
+	@return 读到记录返回true
+	*/
+	bool drain();
+private:
+	bool _closed;
+	bool _corrupt;///<共享段中的长度或位置不合法，读Actor按关闭处理
+	size_t _capacity;///<创建时的环形区大小，不信任共享段头中的值
+	shared_strand _strand;
+	HANDLE _mapping;
+	shm_ring_head* _head;
+	char* _ring;
+	boost::asio::windows::object_handle _event;
+	std::function<void (shared_data)> _msgNotify;
+	std::weak_ptr<shm_ring_reader> _weakThis;
+};
+
+/*!
+@brief 跨进程共享内存环形队列的写端，数据直接写入共享段，队列满时写入失败
+*/
+class shm_ring_writer
+{
+private:
+	shm_ring_writer();
+public:
+	~shm_ring_writer();
+	/*!
+	@brief 打开读端已创建的队列
+	@return 失败返回空
+	*/
+	static std::shared_ptr<shm_ring_writer> open(const char* name);
+public:
+	/*!
+	@brief 在共享段中分配 length 字节直接填写，之后必须调用commit；多写端时分配到commit之间持有写锁；
+	length 不超过1M(msg_data的上限)，也不超过环形区的一半
+	@return 队列满返回NULL
+	*/
+	void* alloc(size_t length);
+
+	/*!
+	@brief 提交alloc的数据，length 不能大于alloc时的长度
+	*/
+	void commit(size_t length);
+
+	/*!
+	@brief 拷贝一个消息到队列，队列满返回false
+	*/
+	bool write(const void* data, size_t length);
+	bool write(shared_data msg);
+private:
+	void unlock();
+private:
+	HANDLE _mapping;
+	HANDLE _event;
+	shm_ring_head* _head;
+	char* _ring;
+	size_t _allocPos;
+	size_t _allocLength;
+};
+
+#endif
@@ -1,16 +1,15 @@
 #include "socket_io.h"
-#include <boost/asio/write.hpp>
-#include <boost/asio/read.hpp>
 
 socket_io::socket_io( boost::asio::io_service& ios )
 	: stream_io_base(ios), _socket(ios)
 {
-
+	RUNTIME_METRIC(_socketAlive.add());
 }
 
 socket_io::~socket_io()
 {
 	close();
+	RUNTIME_METRIC(_socketAlive.sub());
 }
 
 socket_handle socket_io::create(boost::asio::io_service& ios)
@@ -18,6 +17,39 @@ socket_handle socket_io::create(boost::asio::io_service& ios)
 	return socket_handle(new socket_io(ios));
 }
 
+socket_handle socket_io::create(boost::asio::io_service& ios, shared_data protocolInfo)
+{
+	if (!protocolInfo || sizeof(WSAPROTOCOL_INFOA) != protocolInfo->size())
+	{
+		return socket_handle();
+	}
+	WSAPROTOCOL_INFOA* info = (WSAPROTOCOL_INFOA*)protocolInfo->data();
+	SOCKET s = WSASocketA(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, info, 0, WSA_FLAG_OVERLAPPED);
+	if (INVALID_SOCKET == s)
+	{
+		return socket_handle();
+	}
+	socket_handle res(new socket_io(ios));
+	boost::system::error_code ec;
+	res->_socket.assign(AF_INET6 == info->iAddressFamily ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4(), s, ec);
+	if (ec)
+	{
+		closesocket(s);
+		return socket_handle();
+	}
+	return res;
+}
+
+shared_data socket_io::duplicate_to(unsigned pid)
+{
+	WSAPROTOCOL_INFOA info;
+	if (WSADuplicateSocketA(_socket.native_handle(), pid, &info))
+	{
+		return shared_data();
+	}
+	return msg_data::create(&info, sizeof(info));
+}
+
 void socket_io::close()
 {
 	boost::system::error_code ec;
@@ -50,22 +82,28 @@ const std::string socket_io::ip()
 void socket_io::async_connect( const char* ip, size_t port, const std::function<void (const boost::system::error_code&)>& h )
 {
 	auto endPoint = boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::from_string(ip), (unsigned short)port);
+	RUNTIME_METRIC(_socketConnects.add());
 	_socket.async_connect(endPoint, h);
 }
 
 void socket_io::async_write( const unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h )
 {
-	boost::asio::async_write(_socket, boost::asio::buffer(buff, length), h);
+	boost::asio::async_write(_socket, boost::asio::buffer(buff, length), make_bytes_handler(runtime_metrics::_socketWriteBytes, h));
+}
+
+void socket_io::async_write( const std::vector<boost::asio::const_buffer>& buffs, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	boost::asio::async_write(_socket, buffs, make_bytes_handler(runtime_metrics::_socketWriteBytes, h));
 }
 
 void socket_io::async_read_some( unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h )
 {
-	_socket.async_read_some(boost::asio::buffer(buff, length), h);
+	_socket.async_read_some(boost::asio::buffer(buff, length), make_bytes_handler(runtime_metrics::_socketReadBytes, h));
 }
 
 void socket_io::async_read( unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h )
 {
-	boost::asio::async_read(_socket, boost::asio::buffer(buff, length), h);
+	boost::asio::async_read(_socket, boost::asio::buffer(buff, length), make_bytes_handler(runtime_metrics::_socketReadBytes, h));
 }
 
 socket_io::operator boost::asio::ip::tcp::socket&()
@@ -2,14 +2,60 @@
 #define __SOCKET_IO_H
 
 #include "stream_io_base.h"
+#include "handler_allocator.h"
+#include "shared_data.h"
+#include "actor_metrics.h"
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/read.hpp>
 #include <string>
 
 class socket_io;
 typedef std::shared_ptr<socket_io> socket_handle;
 
 /*!
-@brief tcp socketд
+@brief 读写完成时把传输字节数累加到计数器，asio钩子转发给内部Handler
+*/
+template <typename Handler>
+class io_bytes_handler
+{
+public:
+	io_bytes_handler(metric_counter& counter, const Handler& handler)
+		: _counter(&counter), _handler(handler) {}
+
+	void operator()(const boost::system::error_code& ec, size_t bytes)
+	{
+		if (runtime_metrics::enabled())
+		{
+			_counter->add(bytes);
+		}
+		_handler(ec, bytes);
+	}
+
+	template <typename Function>
+	friend void asio_handler_invoke(Function& function, io_bytes_handler* this_handler)
+	{
+		boost_asio_handler_invoke_helpers::invoke(function, this_handler->_handler);
+	}
+
+	template <typename Function>
+	friend void asio_handler_invoke(const Function& function, io_bytes_handler* this_handler)
+	{
+		boost_asio_handler_invoke_helpers::invoke(function, this_handler->_handler);
+	}
+
+	metric_counter* _counter;
+	Handler _handler;
+};
+
+template <typename Handler>
+inline io_bytes_handler<Handler> make_bytes_handler(metric_counter& counter, const Handler& h)
+{
+	return io_bytes_handler<Handler>(counter, h);
+}
+
+/*!
+@brief tcp socket读写
 */
 class socket_io: public stream_io_base
 {
@@ -18,18 +64,63 @@ private:
 public:
 	~socket_io();
 	static socket_handle create(boost::asio::io_service& ios);
+
+	/*!
+	@brief 用另一个进程通过duplicate_to交来的连接信息创建连接
+	*/
+	static socket_handle create(boost::asio::io_service& ios, shared_data protocolInfo);
 public:
+	/*!
+	@brief 把已连接的socket复制给另一个进程，返回的连接信息通过pipe_io等发给目标进程，
+	本进程随后可以close
+	@param pid 目标进程ID
+	@return 失败返回空
+	*/
+	shared_data duplicate_to(unsigned pid);
 	void close();
 	const std::string ip();
 	bool no_delay();
 	void async_connect(const char* ip, size_t port, const std::function<void (const boost::system::error_code&)>& h);
 	void async_write(const unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h);
+	void async_write(const std::vector<boost::asio::const_buffer>& buffs, const std::function<void (const boost::system::error_code&, size_t)>& h);
 	void async_read_some(unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h);
 	void async_read(unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h);
+
+	/*!
+	@brief 模板版本，Handler不转成std::function，asio操作对象放在本socket的读/写内存块中，
+	稳定的单读单写循环不再有堆分配；
+	操作完成(包括close后以operation_aborted完成)并回调之前socket对象必须有效，否则完成端口会写入已释放的内存块，
+	不能保证这一点的(如通过stream_io_base使用)走上面的std::function版本，操作对象从堆分配
+	*/
+	template <typename Handler>
+	void async_write(const unsigned char* buff, size_t length, const Handler& h)
+	{
+		boost::asio::async_write(_socket, boost::asio::buffer(buff, length), make_alloc_handler(_writeAlloc, make_bytes_handler(runtime_metrics::_socketWriteBytes, h)));
+	}
+
+	template <typename Handler>
+	void async_write(const std::vector<boost::asio::const_buffer>& buffs, const Handler& h)
+	{
+		boost::asio::async_write(_socket, buffs, make_alloc_handler(_writeAlloc, make_bytes_handler(runtime_metrics::_socketWriteBytes, h)));
+	}
+
+	template <typename Handler>
+	void async_read_some(unsigned char* buff, size_t length, const Handler& h)
+	{
+		_socket.async_read_some(boost::asio::buffer(buff, length), make_alloc_handler(_readAlloc, make_bytes_handler(runtime_metrics::_socketReadBytes, h)));
+	}
+
+	template <typename Handler>
+	void async_read(unsigned char* buff, size_t length, const Handler& h)
+	{
+		boost::asio::async_read(_socket, boost::asio::buffer(buff, length), make_alloc_handler(_readAlloc, make_bytes_handler(runtime_metrics::_socketReadBytes, h)));
+	}
 	operator boost::asio::ip::tcp::socket& ();
 private:
 	std::string _ip;
 	boost::asio::ip::tcp::socket _socket;
+	handler_allocator<> _readAlloc;
+	handler_allocator<> _writeAlloc;
 };
 
 #endif
\ No newline at end of file
@@ -12,7 +12,7 @@
 
 
 /*!
-@brief ޸ı׼boost strandimpl_Ϊռ
+@brief 修改标准boost strand，impl_改为独占
 */
 class strand_ex
 {
@@ -3,11 +3,13 @@
 
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/buffer.hpp>
 #include <functional>
 #include <memory>
+#include <vector>
 
 /*!
-@brief ݽӿ
+@brief 流数据接口类
 */
 class stream_io_base
 {
@@ -20,6 +22,10 @@ public:
 public:
 	virtual void close() = 0;
 	virtual void async_write(const unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h) = 0;
+	/*!
+	@brief scatter-gather写，buffs中所有片段一次写出，片段内存在回调前必须有效
+	*/
+	virtual void async_write(const std::vector<boost::asio::const_buffer>& buffs, const std::function<void (const boost::system::error_code&, size_t)>& h) = 0;
 	virtual void async_read_some(unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h) = 0;
 	virtual void async_read(unsigned char* buff, size_t length, const std::function<void (const boost::system::error_code&, size_t)>& h) = 0;
 private:
@@ -1,9 +1,42 @@
 #include "text_stream_io.h"
 #include "scattered.h"
 
+#define TEXT_READ_BUFF_SIZE		(4 kB)
+
+text_lines::text_lines(const shared_data& buff)
+: _buff(buff)
+{
+
+}
+
+size_t text_lines::size()
+{
+	return _lines.size();
+}
+
+const char* text_lines::line(size_t i)
+{
+	assert(i < _lines.size());
+	return _buff->c_str() + _lines[i].first;
+}
+
+size_t text_lines::length(size_t i)
+{
+	assert(i < _lines.size());
+	return _lines[i].second;
+}
+
+shared_data text_lines::msg(size_t i)
+{
+	return msg_data::create(line(i), length(i)+1);
+}
+//////////////////////////////////////////////////////////////////////////
+
 text_stream_io::text_stream_io()
 {
 	_closed = false;
+	_maxBatchBytes = 0;
+	_maxLineLength = 0;
 }
 
 text_stream_io::~text_stream_io()
@@ -11,11 +44,33 @@ text_stream_io::~text_stream_io()
 
 }
 
-std::shared_ptr<text_stream_io> text_stream_io::create( shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_data)>& h )
+std::shared_ptr<text_stream_io> text_stream_io::create( shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_data)>& h,
+	size_t maxBatchBytes, size_t maxLineLength )
+{
+	return create_batch(strand, ioObj, [h](shared_lines lines)
+	{
+		if (!lines)
+		{
+			h(shared_data());
+			return;
+		}
+		for (size_t i = 0; i < lines->size(); i++)
+		{
+			h(lines->msg(i));
+		}
+	}, maxBatchBytes, maxLineLength);
+}
+
+std::shared_ptr<text_stream_io> text_stream_io::create_batch( shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_lines)>& h,
+	size_t maxBatchBytes, size_t maxLineLength )
 {
+	assert(maxBatchBytes);
+	assert(maxLineLength && maxLineLength <= 1024 kB);
 	std::shared_ptr<text_stream_io> res(new text_stream_io);
 	res->_ioObj = ioObj;
-	res->_msgNotify = h;
+	res->_maxBatchBytes = maxBatchBytes;
+	res->_maxLineLength = maxLineLength;
+	res->_linesNotify = h;
 	auto wc = my_actor::create(strand, [res](my_actor* self){res->writeActor(self); });
 	res->_writerPipeIn = wc->make_msg_notifer(res->_writerPipeOut);
 	auto rc = my_actor::create(strand, [res](my_actor* self){res->readActor(self); });
@@ -41,82 +96,119 @@ bool text_stream_io::write( shared_data msg )
 
 void text_stream_io::readActor( my_actor* self )
 {
-	unsigned char buff[4096];
-	size_t msgLength = 0;
+	const size_t initSize = TEXT_READ_BUFF_SIZE < _maxLineLength ? TEXT_READ_BUFF_SIZE : _maxLineLength;
+	shared_data buff = msg_data::create(initSize);
+	size_t dataLength = 0;//缓冲区中有效数据长度
+	size_t scanPos = 0;//[0, scanPos)已确认没有分隔符
 	while (true)
 	{
+		if (dataLength == buff->size())
+		{
+			//缓冲区满了还没有一个完整行，扩大缓冲区，超过最大行长度时断开
+			if (buff->size() >= _maxLineLength)
+			{
+				_ioObj->close();
+				break;
+			}
+			size_t newSize = buff->size()*2;
+			buff->resize(newSize < _maxLineLength ? newSize : _maxLineLength);
+		}
 		actor_trig_handle<boost::system::error_code, size_t> ath;
-		_ioObj->async_read_some(buff+msgLength, sizeof(buff)-msgLength, self->make_trig_notifer(ath));
+		_ioObj->async_read_some((unsigned char*)buff->data()+dataLength, buff->size()-dataLength, self->make_trig_notifer(ath));
 		boost::system::error_code ec;
 		size_t length;
 		self->wait_trig(ath, ec, length);
 		if (ec || 0 == length)
 		{
-			_msgNotify(shared_data());
 			break;
 		}
-		size_t i = msgLength;
-		size_t ei = msgLength+length;
-		for (; i < ei; i++)
+		dataLength += length;
+		char* p = buff->c_str();
+		size_t lineBegin = 0;
+		size_t i = scanPos;
+		shared_lines lines;
+		while (i < dataLength)
 		{
-			char tc = buff[i];
-			if (tc == '\r' || tc == '\n')
+			size_t e = i + find_crlf(p+i, dataLength-i);
+			if (e == dataLength)
+			{
+				break;
+			}
+			if (e != lineBegin)
 			{
-				if (msgLength)
+				if (!lines)
 				{
-					shared_data msg = msg_data::create(msgLength+1);
-					memcpy(msg->data(), buff+i-msgLength, msgLength);
-					msg->c_str()[msgLength] = 0;
-					_msgNotify(msg);
-					msgLength = 0;
+					lines = shared_lines(new text_lines(buff));
 				}
-			} 
-			else
-			{
-				msgLength++;
+				p[e] = 0;
+				lines->_lines.push_back(std::pair<size_t, size_t>(lineBegin, e-lineBegin));
 			}
+			i = lineBegin = e+1;
 		}
-		if (msgLength && i != msgLength)
+		size_t tailLength = dataLength-lineBegin;
+		if (lines)
 		{
-			memcpy(buff, buff+i-msgLength, msgLength);
+			//缓冲区交给回调方，剩余的半行移到新缓冲区
+			size_t newSize = tailLength + TEXT_READ_BUFF_SIZE;
+			shared_data newBuff = msg_data::create(newSize < _maxLineLength ? newSize : _maxLineLength);
+			memcpy(newBuff->data(), p+lineBegin, tailLength);
+			buff = newBuff;
+			_linesNotify(lines);
 		}
+		else if (lineBegin)
+		{
+			memmove(p, p+lineBegin, tailLength);
+		}
+		dataLength = tailLength;
+		scanPos = tailLength;
 	}
+	_linesNotify(shared_lines());
 	_writerPipeIn(shared_data());
-	clear_function(_msgNotify);
+	clear_function(_linesNotify);
 }
 
 void text_stream_io::writeActor( my_actor* self )
 {
-	string textTail = "\r\n";
-	while (true)
+	static const char textTail[] = "\r\n";
+	std::vector<boost::asio::const_buffer> buffs;
+	list<shared_data> batch;
+	bool exit = false;
+	while (!exit)
 	{
 		shared_data msg = self->wait_msg(_writerPipeOut);
 		if (!msg)
 		{
 			break;
 		}
+		//取出队列中所有待发消息，与"\r\n"交错组成一个gather列表，一次写出
+		size_t batchBytes = 0;
+		while (true)
 		{
-			actor_trig_handle<boost::system::error_code, size_t> ath;
-			_ioObj->async_write((unsigned char*)msg->data(), msg->size(), self->make_trig_notifer(ath));
-			boost::system::error_code ec;
-			size_t length;
-			self->wait_trig(ath, ec, length);
-			if (ec)
+			buffs.push_back(boost::asio::const_buffer(msg->data(), msg->size()));
+			buffs.push_back(boost::asio::const_buffer(textTail, sizeof(textTail)-1));
+			batchBytes += msg->size()+sizeof(textTail)-1;
+			batch.push_back(msg);
+			if (batchBytes >= _maxBatchBytes || !self->try_wait_msg(_writerPipeOut, msg))
 			{
 				break;
 			}
-		}
-		{
-			actor_trig_handle<boost::system::error_code, size_t> ath;
-			_ioObj->async_write((unsigned char*)textTail.c_str(), textTail.size(), self->make_trig_notifer(ath));
-			boost::system::error_code ec;
-			size_t length;
-			self->wait_trig(ath, ec, length);
-			if (ec)
+			if (!msg)
 			{
+				exit = true;
 				break;
 			}
 		}
+		actor_trig_handle<boost::system::error_code, size_t> ath;
+		_ioObj->async_write(buffs, self->make_trig_notifer(ath));
+		boost::system::error_code ec;
+		size_t length;
+		self->wait_trig(ath, ec, length);
+		buffs.clear();
+		batch.clear();
+		if (ec)
+		{
+			break;
+		}
 	}
 	self->close_msg_notifer(_writerPipeOut);
 	_closed = true;
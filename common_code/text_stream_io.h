@@ -4,9 +4,47 @@
 #include "stream_io_base.h"
 #include "shared_data.h"
 #include "actor_framework.h"
+#include <vector>
+
+class text_stream_io;
 
 /*!
-@brief ı
+@brief 一次读取中解析出的一批文本行，所有行共享同一块缓冲区(不拷贝)，行尾分隔符已被替换为'\0'
+*/
+class text_lines;
+typedef std::shared_ptr<text_lines> shared_lines;
+class text_lines
+{
+	friend text_stream_io;
+private:
+	text_lines(const shared_data& buff);
+public:
+	/*!
+	@brief 行数
+	*/
+	size_t size();
+
+	/*!
+	@brief 第 i 行，以'\0'结尾
+	*/
+	const char* line(size_t i);
+
+	/*!
+	@brief 第 i 行长度，不含结尾'\0'
+	*/
+	size_t length(size_t i);
+
+	/*!
+	@brief 把第 i 行拷贝成独立的消息包(含结尾'\0')
+	*/
+	shared_data msg(size_t i);
+private:
+	shared_data _buff;
+	std::vector<std::pair<size_t, size_t> > _lines;
+};
+
+/*!
+@brief 文本数据流解析类
 */
 class text_stream_io
 {
@@ -14,7 +52,21 @@ private:
 	text_stream_io();
 public:
 	~text_stream_io();
-	static std::shared_ptr<text_stream_io> create(shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_data)>& h);
+	/*!
+	@brief 创建文本流
+	@param h 收到一行文本时的回调，断开时参数为空
+	@param maxBatchBytes 写合并时单次写出的字节上限
+	@param maxLineLength 单行最大长度(不超过1M)，超过时断开
+	*/
+	static std::shared_ptr<text_stream_io> create(shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_data)>& h,
+		size_t maxBatchBytes = 64 kB, size_t maxLineLength = 64 kB);
+
+	/*!
+	@brief 创建文本流，每次读取解析出的所有行打包成一批回调，行数据不逐行拷贝
+	@param h 收到一批文本时的回调，断开时参数为空
+	*/
+	static std::shared_ptr<text_stream_io> create_batch(shared_strand strand, std::shared_ptr<stream_io_base> ioObj, const std::function<void (shared_lines)>& h,
+		size_t maxBatchBytes = 64 kB, size_t maxLineLength = 64 kB);
 public:
 	void close();
 	bool write(shared_data msg);
@@ -23,8 +75,10 @@ private:
 	void writeActor(my_actor* self);
 private:
 	bool _closed;
+	size_t _maxBatchBytes;
+	size_t _maxLineLength;
 	std::shared_ptr<stream_io_base> _ioObj;
-	std::function<void (shared_data)> _msgNotify;
+	std::function<void (shared_lines)> _linesNotify;
 	std::function<void (shared_data)> _writerPipeIn;
 	actor_msg_handle<shared_data> _writerPipeOut;
 };
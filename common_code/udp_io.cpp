@@ -0,0 +1,182 @@
+#include "udp_io.h"
+#include <boost/asio/ip/multicast.hpp>
+#include <assert.h>
+
+udp_io::udp_io( boost::asio::io_service& ios )
+	: _socket(ios)
+{
+
+}
+
+udp_io::~udp_io()
+{
+	close();
+}
+
+udp_handle udp_io::create( boost::asio::io_service& ios )
+{
+	udp_handle res(new udp_io(ios));
+	res->_weakThis = res;
+	return res;
+}
+
+bool udp_io::open( size_t port, bool reuse )
+{
+	boost::system::error_code ec;
+	_socket.open(boost::asio::ip::udp::v4(), ec);
+	if (!ec && reuse)
+	{
+		_socket.set_option(boost::asio::ip::udp::socket::reuse_address(true), ec);
+	}
+	if (!ec)
+	{
+		_socket.bind(boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), (unsigned short)port), ec);
+	}
+	if (!ec)
+	{
+		//只影响同步收发，用于批量收发时不阻塞地取完/发出已就绪的数据报
+		_socket.non_blocking(true, ec);
+	}
+	if (ec)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool udp_io::join_group( const char* ip )
+{
+	boost::system::error_code ec;
+	_socket.set_option(boost::asio::ip::multicast::join_group(boost::asio::ip::address::from_string(ip, ec)), ec);
+	return !ec;
+}
+
+void udp_io::close()
+{
+	boost::system::error_code ec;
+	_socket.close(ec);
+}
+
+size_t udp_io::local_port()
+{
+	boost::system::error_code ec;
+	return _socket.local_endpoint(ec).port();
+}
+
+boost::asio::ip::udp::endpoint udp_io::endpoint( const char* ip, size_t port )
+{
+	return boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::from_string(ip), (unsigned short)port);
+}
+
+void udp_io::async_send_to( const unsigned char* buff, size_t length, const boost::asio::ip::udp::endpoint& remote, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	_socket.async_send_to(boost::asio::buffer(buff, length), remote, h);
+}
+
+void udp_io::async_receive_from( unsigned char* buff, size_t length, boost::asio::ip::udp::endpoint& remote, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	_socket.async_receive_from(boost::asio::buffer(buff, length), remote, h);
+}
+
+void udp_io::async_receive_batch( size_t maxCount, size_t maxDatagram, const std::function<void (const boost::system::error_code&, udp_batch)>& h )
+{
+	assert(maxCount && maxDatagram && maxDatagram <= 64 * 1024);
+	if (!_recvBuff || _recvBuff->size() < maxDatagram)
+	{
+		_recvBuff = msg_data::create(maxDatagram);
+	}
+	//操作对象放在本对象的内存块中，并写入_recvRemote，完成前用shared_this保持本对象有效
+	udp_handle shared_this = _weakThis.lock();
+	_socket.async_receive_from(boost::asio::buffer(_recvBuff->data(), maxDatagram), _recvRemote, make_alloc_handler(_readAlloc,
+		[shared_this, maxCount, maxDatagram, h](const boost::system::error_code& ec, size_t length)
+	{
+		if (ec == boost::asio::error::message_size)
+		{//数据报超长，缓冲区里是截断的前 maxDatagram 字节
+			shared_this->receive_batch_next(maxCount, maxDatagram, maxDatagram, true, h);
+			return;
+		}
+		if (ec)
+		{
+			h(ec, udp_batch());
+			return;
+		}
+		shared_this->receive_batch_next(maxCount, maxDatagram, length, false, h);
+	}));
+}
+
+void udp_io::receive_batch_next( size_t maxCount, size_t maxDatagram, size_t length, bool truncated, const std::function<void (const boost::system::error_code&, udp_batch)>& h )
+{
+	udp_batch batch(new std::vector<udp_datagram>);
+	batch->reserve(maxCount);
+	//第一个数据报已由异步接收取得，后面的不阻塞地取，直到没有或取满一批
+	while (true)
+	{
+		udp_datagram dg;
+		dg._msg = msg_data::create(_recvBuff->data(), length);
+		dg._remote = _recvRemote;
+		dg._truncated = truncated;
+		batch->push_back(dg);
+		if (batch->size() >= maxCount)
+		{
+			break;
+		}
+		boost::system::error_code ec;
+		length = _socket.receive_from(boost::asio::buffer(_recvBuff->data(), maxDatagram), _recvRemote, 0, ec);
+		truncated = ec == boost::asio::error::message_size;
+		if (truncated)
+		{
+			length = maxDatagram;
+		}
+		else if (ec)
+		{
+			break;
+		}
+	}
+	h(boost::system::error_code(), batch);
+}
+
+void udp_io::async_send_batch( const udp_batch& batch, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	send_batch_next(batch, 0, h);
+}
+
+void udp_io::send_batch_next( const udp_batch& batch, size_t i, const std::function<void (const boost::system::error_code&, size_t)>& h )
+{
+	for (; i < batch->size(); i++)
+	{
+		udp_datagram& dg = (*batch)[i];
+		boost::system::error_code ec;
+		_socket.send_to(boost::asio::buffer(dg._msg->data(), dg._msg->size()), dg._remote, 0, ec);
+		if (ec == boost::asio::error::would_block)
+		{
+			//发送缓冲区满，剩余部分异步等待
+			udp_handle shared_this = _weakThis.lock();
+			_socket.async_send_to(boost::asio::buffer(dg._msg->data(), dg._msg->size()), dg._remote, make_alloc_handler(_writeAlloc,
+				[shared_this, batch, i, h](const boost::system::error_code& err, size_t)
+			{
+				if (err)
+				{
+					h(err, i);
+					return;
+				}
+				shared_this->send_batch_next(batch, i+1, h);
+			}));
+			return;
+		}
+		if (ec)
+		{
+			h(ec, i);
+			return;
+		}
+	}
+	_socket.get_io_service().post([h, i]()
+	{
+		h(boost::system::error_code(), i);
+	});
+}
+
+udp_io::operator boost::asio::ip::udp::socket&()
+{
+	return _socket;
+}
@@ -0,0 +1,95 @@
+#ifndef __UDP_IO_H
+#define __UDP_IO_H
+
+#include "shared_data.h"
+#include "handler_allocator.h"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/*!
+@brief 一个数据报，_remote 为收到时的来源地址或发送时的目标地址
+*/
+struct udp_datagram
+{
+	udp_datagram()
+		:_truncated(false) {}
+
+	shared_data _msg;
+	boost::asio::ip::udp::endpoint _remote;
+	bool _truncated;///<收到的数据报比缓冲区长，_msg 只有前面一部分
+};
+
+/*!
+@brief 一批数据报，一次唤醒中收到的或要一次发出的
+*/
+typedef std::shared_ptr<std::vector<udp_datagram> > udp_batch;
+
+class udp_io;
+typedef std::shared_ptr<udp_io> udp_handle;
+
+/*!
+@brief udp socket读写，支持按批收发
+*/
+class udp_io
+{
+private:
+	udp_io(boost::asio::io_service& ios);
+public:
+	~udp_io();
+	static udp_handle create(boost::asio::io_service& ios);
+public:
+	/*!
+	@brief 打开并绑定本地端口，port为0时由系统分配
+	*/
+	bool open(size_t port = 0, bool reuse = true);
+
+	/*!
+	@brief 加入组播组
+	*/
+	bool join_group(const char* ip);
+	void close();
+	size_t local_port();
+
+	/*!
+	@brief 生成目标地址
+	*/
+	static boost::asio::ip::udp::endpoint endpoint(const char* ip, size_t port);
+
+	void async_send_to(const unsigned char* buff, size_t length, const boost::asio::ip::udp::endpoint& remote, const std::function<void (const boost::system::error_code&, size_t)>& h);
+
+	/*!
+	@brief 接收一个数据报，数据报比缓冲区长时 h 收到 boost::asio::error::message_size(WSAEMSGSIZE)，
+	缓冲区中是截断后的数据，socket可以继续使用
+	*/
+	void async_receive_from(unsigned char* buff, size_t length, boost::asio::ip::udp::endpoint& remote, const std::function<void (const boost::system::error_code&, size_t)>& h);
+
+	/*!
+	@brief 按批接收，异步等到第一个数据报后，把socket中已到达的数据报不阻塞地一次取完(最多maxCount个)，一次回调，
+	可直接传入actor的trig通知句柄
+	@param maxCount 一批最多数据报个数
+	@param maxDatagram 单个数据报最大长度，超长的数据报(Windows下以WSAEMSGSIZE完成)截断后放入批中，标记 _truncated
+	批量收发的异步操作放在本对象的内存块中并持有本对象，等待期间释放udp_handle不会关闭socket，不再使用时调用close
+	*/
+	void async_receive_batch(size_t maxCount, size_t maxDatagram, const std::function<void (const boost::system::error_code&, udp_batch)>& h);
+
+	/*!
+	@brief 按批发送，不阻塞地逐个发出，发送缓冲区满时异步等待后继续，全部发完或出错时回调已发出的个数
+	*/
+	void async_send_batch(const udp_batch& batch, const std::function<void (const boost::system::error_code&, size_t)>& h);
+	operator boost::asio::ip::udp::socket& ();
+private:
+	void receive_batch_next(size_t maxCount, size_t maxDatagram, size_t length, bool truncated, const std::function<void (const boost::system::error_code&, udp_batch)>& h);
+	void send_batch_next(const udp_batch& batch, size_t i, const std::function<void (const boost::system::error_code&, size_t)>& h);
+private:
+	boost::asio::ip::udp::socket _socket;
+	boost::asio::ip::udp::endpoint _recvRemote;
+	shared_data _recvBuff;
+	std::weak_ptr<udp_io> _weakThis;
+	handler_allocator<> _readAlloc;
+	handler_allocator<> _writeAlloc;
+};
+
+#endif
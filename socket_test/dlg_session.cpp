@@ -1,4 +1,4 @@
-// dlg_session.cpp : ʵļ
+// dlg_session.cpp : 实现文件
 //
 
 #include "stdafx.h"
@@ -7,7 +7,7 @@
 #include "afxdialogex.h"
 
 
-// dlg_session Ի
+// dlg_session 对话框
 
 IMPLEMENT_DYNAMIC(dlg_session, CDialogEx)
 
@@ -40,7 +40,7 @@ BOOL dlg_session::OnInitDialog()
 	set_thread_id();
 	CDialogEx::OnInitDialog();
 
-	_editFont.CreatePointFont(90, "");
+	_editFont.CreatePointFont(90, "宋体");
 	_msgEdit.SetFont(&_editFont);
 	_outputEdit.SetFont(&_editFont);
 	return TRUE;
@@ -59,7 +59,7 @@ void dlg_session::waitQuit(my_actor* parent)
 	parent->child_actor_wait_quit(_sessionActor);
 }
 
-// dlg_session Ϣ
+// dlg_session 消息处理程序
 
 void dlg_session::OnCancel()
 {
@@ -83,7 +83,7 @@ void dlg_session::sessionActor(my_actor* self)
 	child_actor_handle lstClose = self->create_child_actor([&, this](my_actor* self)
 	{
 		auto amh = self->connect_msg_pump();
-		//ԻرϢȻ֪ͨԻر
+		//侦听请求对话框关闭消息，然后通知对话框关闭
 		self->pump_msg(amh);
 		this->_exit = true;
 		_socket->close();
@@ -118,7 +118,7 @@ void dlg_session::sessionActor(my_actor* self)
 	}
 	self->child_actor_force_quit(wd);
 	self->close_msg_notifer(amh);
-	post(boost::bind(&dlg_session::showClientMsg, this, msg_data::create("ӶϿ")));
+	post(boost::bind(&dlg_session::showClientMsg, this, msg_data::create("连接断开")));
 	send(self, [this]()
 	{
 		this->GetDlgItem(IDC_BUTTON3)->EnableWindow(FALSE);
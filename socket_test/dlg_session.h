@@ -5,21 +5,21 @@
 #include "text_stream_io.h"
 
 
-// dlg_session Ի
+// dlg_session 对话框
 
 class dlg_session : public CDialogEx, bind_mfc_run
 {
 	DECLARE_DYNAMIC(dlg_session)
 
 public:
-	dlg_session(CWnd* pParent = NULL);   // ׼캯
+	dlg_session(CWnd* pParent = NULL);   // 标准构造函数
 	virtual ~dlg_session();
 
-// Ի
+// 对话框数据
 	enum { IDD = IDD_SESSION };
 
 protected:
-	virtual void DoDataExchange(CDataExchange* pDX);    // DDX/DDV ֧
+	virtual void DoDataExchange(CDataExchange* pDX);    // DDX/DDV 支持
 	virtual BOOL OnInitDialog();
 
 	afx_msg void OnBnClickedSendMsg();
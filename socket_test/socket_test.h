@@ -1,18 +1,18 @@
 
-// socket_test.h : PROJECT_NAME Ӧóͷļ
+// socket_test.h : PROJECT_NAME 应用程序的主头文件
 //
 
 #pragma once
 
 #ifndef __AFXWIN_H__
-	#error "ڰļ֮ǰstdafx.h PCH ļ"
+	#error "在包含此文件之前包含“stdafx.h”以生成 PCH 文件"
 #endif
 
-#include "resource.h"		// 
+#include "resource.h"		// 主符号
 
 
 // Csocket_testApp:
-// йشʵ֣ socket_test.cpp
+// 有关此类的实现，请参阅 socket_test.cpp
 //
 
 class Csocket_testApp : public CWinApp
@@ -20,11 +20,11 @@ class Csocket_testApp : public CWinApp
 public:
 	Csocket_testApp();
 
-// д
+// 重写
 public:
 	virtual BOOL InitInstance();
 
-// ʵ
+// 实现
 
 	DECLARE_MESSAGE_MAP()
 };
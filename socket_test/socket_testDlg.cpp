@@ -1,4 +1,4 @@
-// socket_testDlg.cpp : ʵļ
+// socket_testDlg.cpp : 实现文件
 //
 
 #include "stdafx.h"
@@ -13,7 +13,7 @@
 #endif
 
 
-// Csocket_testDlg Ի
+// Csocket_testDlg 对话框
 
 
 
@@ -53,16 +53,16 @@ BEGIN_MESSAGE_MAP(Csocket_testDlg, CDialogEx)
 END_MESSAGE_MAP()
 
 
-// Csocket_testDlg Ϣ
+// Csocket_testDlg 消息处理程序
 
 BOOL Csocket_testDlg::OnInitDialog()
 {
 	set_thread_id();
 	CDialogEx::OnInitDialog();
 
-	// ...˵ӵϵͳ˵С
+	// 将“关于...”菜单项添加到系统菜单中。
 
-	// IDM_ABOUTBOX ϵͳΧڡ
+	// IDM_ABOUTBOX 必须在系统命令范围内。
 	ASSERT((IDM_ABOUTBOX & 0xFFF0) == IDM_ABOUTBOX);
 	ASSERT(IDM_ABOUTBOX < 0xF000);
 
@@ -80,16 +80,16 @@ BOOL Csocket_testDlg::OnInitDialog()
 		}
 	}
 
-	// ô˶ԻͼꡣӦóڲǶԻʱܽԶ
-	//  ִд˲
-	SetIcon(m_hIcon, TRUE);			// ôͼ
-	SetIcon(m_hIcon, FALSE);		// Сͼ
+	// 设置此对话框的图标。当应用程序主窗口不是对话框时，框架将自动
+	//  执行此操作
+	SetIcon(m_hIcon, TRUE);			// 设置大图标
+	SetIcon(m_hIcon, FALSE);		// 设置小图标
 	GetDlgItem(IDC_BUTTON2)->EnableWindow(FALSE);
 	GetDlgItem(IDC_BUTTON3)->EnableWindow(FALSE);
 	GetDlgItem(IDC_BUTTON5)->EnableWindow(FALSE);
 
-	// TODO: ڴӶĳʼ
-	_editFont.CreatePointFont(90, "");
+	// TODO: 在此添加额外的初始化代码
+	_editFont.CreatePointFont(90, "宋体");
 	_clientIpEdit.SetFont(&_editFont);
 	_clientPortEdit.SetFont(&_editFont);
 	_clientTimeoutEdit.SetFont(&_editFont);
@@ -118,7 +118,7 @@ BOOL Csocket_testDlg::OnInitDialog()
 	actor_handle mainActor = my_actor::create(_strand, boost::bind(&Csocket_testDlg::mainActor, this, _1));
 	_uiCMD = mainActor->connect_msg_notifer<ui_cmd>();
 	mainActor->notify_run();
-	return TRUE;  // ǽõؼ򷵻 TRUE
+	return TRUE;  // 除非将焦点设置到控件，否则返回 TRUE
 }
 
 void Csocket_testDlg::showClientMsg(shared_data msg)
@@ -173,21 +173,21 @@ void Csocket_testDlg::OnBnClickedClear()
 void Csocket_testDlg::connectActor(my_actor* self, std::shared_ptr<client_param> param)
 {
 	actor_trig_handle<boost::system::error_code> ath;
-	post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("...")));
+	post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("连接中...")));
 	param->_clientSocket->async_connect(param->_ip.c_str(), param->_port, self->make_trig_notifer(ath));
 	actor_handle connecting = create_mfc_actor(_ios, [this](my_actor* self)
-	{//áӡť˸
+	{//让“连接”按钮在连接中闪烁
 		self->open_timer();
 		this->GetDlgItem(IDC_BUTTON1)->EnableWindow(TRUE);
 		while (true)
 		{
-			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("   ");
+			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("连接中   ");
 			self->sleep(250);
-			this->GetDlgItem(IDC_BUTTON1)->SetWindowText(".  ");
+			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("连接中.  ");
 			self->sleep(250);
-			this->GetDlgItem(IDC_BUTTON1)->SetWindowText(".. ");
+			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("连接中.. ");
 			self->sleep(250);
-			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("...");
+			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("连接中...");
 			self->sleep(250);
 		}
 	});
@@ -200,15 +200,15 @@ void Csocket_testDlg::connectActor(my_actor* self, std::shared_ptr<client_param>
 		send(self, [this]()
 		{
 			this->GetDlgItem(IDC_BUTTON1)->EnableWindow(FALSE);
-			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("");
+			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("连接");
 		});
-		post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("ӳɹ")));
+		post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("连接成功")));
 		actor_msg_handle<shared_data> amh;
 		child_actor_handle readActor = self->create_child_actor([this, &amh](my_actor* self)
 		{
 			while (true)
 			{
-				//շϢȻ͸Ի
+				//接收服务器的消息，然后发送给对话框
 				shared_data msg = self->wait_msg(amh);
 				if (!msg)
 				{
@@ -225,7 +225,7 @@ void Csocket_testDlg::connectActor(my_actor* self, std::shared_ptr<client_param>
 		{
 			while (true)
 			{
-				//նԻϢȻ͸
+				//接收对话框给的消息，然后发送给服务器
 				textio->write(self->pump_msg(*amh));
 			}
 		});
@@ -236,7 +236,7 @@ void Csocket_testDlg::connectActor(my_actor* self, std::shared_ptr<client_param>
 		self->child_actor_wait_quit(readActor);
 		self->child_actor_force_quit(writerActor);
 		textio->close();
-		post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("Ͽ")));
+		post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("断开连接")));
 	} 
 	else
 	{
@@ -244,16 +244,16 @@ void Csocket_testDlg::connectActor(my_actor* self, std::shared_ptr<client_param>
 		send(self, [this]()
 		{
 			this->GetDlgItem(IDC_BUTTON1)->EnableWindow(FALSE);
-			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("");
+			this->GetDlgItem(IDC_BUTTON1)->SetWindowText("连接");
 		});
-		post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("ʧ")));
+		post(boost::bind(&Csocket_testDlg::showClientMsg, this, msg_data::create("连接失败")));
 		param->_clientSocket->close();
 	}
 	_uiCMD(ui_disconnect);
 }
 
 void Csocket_testDlg::newSession(my_actor* self, std::shared_ptr<session_pck> sess)
-{//ActorڶԻ߳
+{//这个Actor运行在对话框线程中
 	actor_trig_handle<> lstClose;
 	dlg_session dlg;
 	dlg._strand = _strand;
@@ -271,7 +271,7 @@ void Csocket_testDlg::newSession(my_actor* self, std::shared_ptr<session_pck> se
 void Csocket_testDlg::serverActor(my_actor* self, std::shared_ptr<server_param> param)
 {
 	actor_msg_handle<socket_handle> amh;
-	accept_handle accept = acceptor_socket::create(self->self_strand(), param->_port, self->make_msg_notifer(amh), false);//
+	accept_handle accept = acceptor_socket::create(self->self_strand(), param->_port, self->make_msg_notifer(amh), false);//创建连接侦听器
 	if (!accept)
 	{
 		self->close_msg_notifer(amh);
@@ -279,15 +279,15 @@ void Csocket_testDlg::serverActor(my_actor* self, std::shared_ptr<server_param>
 		return;
 	}
 	bool norClosed = false;
-	//ر
-	child_actor_handle lstCloseProxyActor = self->msg_agent_to_actor(true, [&](my_actor* self, msg_pump<>::handle amh)//ر
+	//创建侦听服务器关闭
+	child_actor_handle lstCloseProxyActor = self->msg_agent_to_actor(true, [&](my_actor* self, msg_pump<>::handle amh)//侦听服务器关闭
 	{
 		self->pump_msg(amh);
-		//õرϢر
+		//得到服务器关闭消息，关闭连接侦听器
 		norClosed = true;
 		accept->close();
 	});
-	//ỰرӦ
+	//创建会话关闭响应器
 	list<std::shared_ptr<session_pck> > sessList;
 	actor_msg_handle<list<std::shared_ptr<session_pck> >::iterator> sessDissonnLst;
 	child_actor_handle sessMngActor = self->create_child_actor([&](my_actor* self)
@@ -311,7 +311,7 @@ void Csocket_testDlg::serverActor(my_actor* self, std::shared_ptr<server_param>
 				self->child_actor_force_quit(lstCloseProxyActor);
 				send(self, [this]()
 				{
-					this->MessageBox("ر");
+					this->MessageBox("服务器意外关闭");
 				});
 			}
 			break;
@@ -335,7 +335,7 @@ void Csocket_testDlg::serverActor(my_actor* self, std::shared_ptr<server_param>
 	self->child_actor_wait_quit(lstCloseProxyActor);
 	self->child_actor_force_quit(sessMngActor);
 	self->close_msg_notifer(amh);
-	//֪ͨдڵĶԻر
+	//通知所有存在的对话框关闭
 	for (auto it = sessList.begin(); it != sessList.end(); it++)
 	{
 		(*it)->_closeNtf();
@@ -1,5 +1,5 @@
 
-// socket_testDlg.h : ͷļ
+// socket_testDlg.h : 头文件
 //
 
 #pragma once
@@ -13,15 +13,15 @@
 #include "dlg_session.h"
 
 
-// Csocket_testDlg Ի
+// Csocket_testDlg 对话框
 class Csocket_testDlg : public CDialogEx, bind_mfc_run
 {
-// 
+// 构造
 public:
-	Csocket_testDlg(CWnd* pParent = NULL);	// ׼캯
+	Csocket_testDlg(CWnd* pParent = NULL);	// 标准构造函数
 	~Csocket_testDlg();
 
-// Ի
+// 对话框数据
 	enum { IDD = IDD_SOCKET_TEST_DIALOG };
 
 	enum ui_cmd
@@ -35,7 +35,7 @@ public:
 	};
 
 	protected:
-	virtual void DoDataExchange(CDataExchange* pDX);	// DDX/DDV ֧
+	virtual void DoDataExchange(CDataExchange* pDX);	// DDX/DDV 支持
 
 	struct client_param 
 	{
@@ -57,11 +57,11 @@ public:
 		post_actor_msg<> _closeNtf;
 		actor_handle _sessionDlg;
 	};
-// ʵ
+// 实现
 protected:
 	HICON m_hIcon;
 
-	// ɵϢӳ亯
+	// 生成的消息映射函数
 	virtual BOOL OnInitDialog();
 	afx_msg void OnBnClickedClientConnect();
 	afx_msg void OnBnClickedClientDisconnect();